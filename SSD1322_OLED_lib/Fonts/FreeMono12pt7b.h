@@ -260,7 +260,11 @@ const GFXfont FreeMono12pt7b = {
 		(GFXglyph *)FreeMono12pt7bGlyphs,
 		0x20,
 		0x7E,
-		24
+		24,
+		NULL,    // contiguous font, no codepoint table
+		0,
+		NULL,    // bitmaps in internal flash, no loader
+		NULL
 };
 
 #ifdef __cplusplus
@@ -253,7 +253,11 @@ const GFXfont FreeSansOblique9pt7b = {
     (GFXglyph *)FreeSansOblique9pt7bGlyphs,
 	0x20,
 	0x7E,
-	22};
+	22,
+	NULL,    // contiguous font, no codepoint table
+	0,
+	NULL,    // bitmaps in internal flash, no loader
+	NULL};
 
 // Approx. 2041 bytes
 
@@ -17,82 +17,135 @@
 #include "../SSD1322_OLED_lib/SSD1322_API.h"
 
 
+//====================== init sequence ========================//
+/*
+ *  Every entry is a command byte, amount of its parameters and the parameters.
+ */
+static const uint8_t init_sequence[] =
+{
+	0xFD, 1, 0x12,                         //set Command unlock
+	0xAE, 0,                               //set display off
+	0xB3, 1, 0x91,                         //set display clock divide ratio
+	0xCA, 1, 0x3F,                         //set multiplex ratio
+	0xA2, 1, 0x00,                         //set display offset to 0
+	0xA1, 1, 0x00,                         //start display start line to 0
+	0xA0, 2, REMAP_DEFAULT, REMAP_DUAL_COM, //set remap and dual COM Line Mode
+	0xB5, 1, 0x00,                         //disable IO input
+	0xAB, 1, 0x01,                         //function select
+	0xB4, 2, 0xA0, 0xFD,                   //enable VSL extern
+	0xC1, 1, 0xFF,                         //set contrast current
+	0xC7, 1, 0x0F,                         //set master contrast current
+	0xB9, 0,                               //default grayscale
+	0xB1, 1, 0xE2,                         //set phase length
+	0xD1, 2, 0x82, 0x20,                   //enhance driving scheme capability
+	0xBB, 1, 0x1F,                         //first pre charge voltage
+	0xB6, 1, 0x08,                         //second pre charge voltage
+	0xBE, 1, 0x07,                         //VCOMH
+	0xA6, 0,                               //set normal display mode
+	0xA9, 0                                //no partial mode
+};
+
 //====================== command ========================//
 /**
  *  @brief Sends command byte to SSD1322
  */
-void SSD1322_API_command(uint8_t command)
+void SSD1322_API_command(SSD1322_device_t *device, uint8_t command)
 {
-	SSD1322_HW_drive_CS_low();
-	SSD1322_HW_drive_DC_low();
-	SSD1322_HW_SPI_send_byte(command);
-	SSD1322_HW_drive_CS_high();
+	device->hw->drive_CS(device->context, 0);
+	device->hw->drive_DC(device->context, 0);
+	device->hw->SPI_send_array(device->context, &command, 1);
+	device->hw->drive_CS(device->context, 1);
 }
 
 //====================== data ========================//
 /**
  *  @brief Sends data byte to SSD1322
  */
-void SSD1322_API_data(uint8_t data)
+void SSD1322_API_data(SSD1322_device_t *device, uint8_t data)
+{
+	device->hw->drive_CS(device->context, 0);
+	device->hw->drive_DC(device->context, 1);
+	device->hw->SPI_send_array(device->context, &data, 1);
+	device->hw->drive_CS(device->context, 1);
+}
+
+//====================== command sequence ========================//
+/**
+ *  @brief Sends sequence of commands with parameters to SSD1322.
+ *
+ *  Every command is sent with its parameters in one CS low period.
+ *
+ *  @param[in] device
+ *             display to send commands to
+ *  @param[in] sequence
+ *             commands, each given as command byte, amount of parameters and parameters
+ *  @param[in] sequence_size
+ *             size of sequence array in bytes
+ */
+void SSD1322_API_command_sequence(SSD1322_device_t *device, const uint8_t *sequence, uint32_t sequence_size)
 {
-	SSD1322_HW_drive_CS_low();
-	SSD1322_HW_drive_DC_high();
-	SSD1322_HW_SPI_send_byte(data);
-	SSD1322_HW_drive_CS_high();
+	uint32_t pos = 0;
+
+	while (pos + 1 < sequence_size)
+	{
+		uint8_t params = sequence[pos + 1];
+
+		device->hw->drive_CS(device->context, 0);
+		device->hw->drive_DC(device->context, 0);
+		device->hw->SPI_send_array(device->context, &sequence[pos], 1);
+		if (params)
+		{
+			device->hw->drive_DC(device->context, 1);
+			device->hw->SPI_send_array(device->context, &sequence[pos + 2], params);
+		}
+		device->hw->drive_CS(device->context, 1);
+		pos += 2 + params;
+	}
 }
 
 //====================== initialization sequence ========================//
 /**
  *  @brief Initializes SSD1322 OLED display.
+ *
+ *  @param[in] device
+ *             display to initialize
+ */
+void SSD1322_API_init(SSD1322_device_t *device)
+{
+	SSD1322_API_init_devices(&device, 1);
+}
+
+//====================== initialize many displays ========================//
+/**
+ *  @brief Initializes several SSD1322 displays at once.
+ *
+ *  Reset and power stabilization delays are waited once for all displays, so initialization
+ *  of any number of displays takes as long as initialization of one.
+ *
+ *  @param[in] devices
+ *             array of pointers to displays
+ *  @param[in] count
+ *             amount of displays
  */
-void SSD1322_API_init()
-{
-	SSD1322_HW_drive_RESET_low();  //Reset pin low
-	SSD1322_HW_msDelay(1);                  //1ms delay
-	SSD1322_HW_drive_RESET_high(); //Reset pin high
-	SSD1322_HW_msDelay(50);                 //50ms delay
-	SSD1322_API_command(0xFD);     //set Command unlock
-	SSD1322_API_data(0x12);
-	SSD1322_API_command(0xAE);     //set display off
-	SSD1322_API_command(0xB3);     //set display clock divide ratio
-	SSD1322_API_data(0x91);
-	SSD1322_API_command(0xCA);     //set multiplex ratio
-	SSD1322_API_data(0x3F);
-	SSD1322_API_command(0xA2);   //set display offset to 0
-	SSD1322_API_data(0x00);
-	SSD1322_API_command(0xA1);   //start display start line to 0
-	SSD1322_API_data(0x00);
-	SSD1322_API_command(0xA0);   //set remap and dual COM Line Mode
-	SSD1322_API_data(0x14);
-	SSD1322_API_data(0x11);
-	SSD1322_API_command(0xB5);   //disable IO input
-	SSD1322_API_data(0x00);
-	SSD1322_API_command(0xAB);   //function select
-	SSD1322_API_data(0x01);
-	SSD1322_API_command(0xB4);   //enable VSL extern
-	SSD1322_API_data(0xA0);
-	SSD1322_API_data(0xFD);
-	SSD1322_API_command(0xC1);   //set contrast current
-	SSD1322_API_data(0xFF);
-	SSD1322_API_command(0xC7);   //set master contrast current
-	SSD1322_API_data(0x0F);
-	SSD1322_API_command(0xB9);   //default grayscale
-	SSD1322_API_command(0xB1);   //set phase length
-	SSD1322_API_data(0xE2);
-	SSD1322_API_command(0xD1);   //enhance driving scheme capability
-	SSD1322_API_data(0x82);
-	SSD1322_API_data(0x20);
-	SSD1322_API_command(0xBB);   //first pre charge voltage
-	SSD1322_API_data(0x1F);
-	SSD1322_API_command(0xB6);   //second pre charge voltage
-	SSD1322_API_data(0x08);
-	SSD1322_API_command(0xBE);   //VCOMH
-	SSD1322_API_data(0x07);
-	SSD1322_API_command(0xA6);   //set normal display mode
-	SSD1322_API_command(0xA9);   //no partial mode
-	SSD1322_HW_msDelay(10);               //stabilize VDD
-	SSD1322_API_command(0xAF);   //display on
-	SSD1322_HW_msDelay(50);               //stabilize VDD
+void SSD1322_API_init_devices(SSD1322_device_t **devices, uint8_t count)
+{
+	if (count == 0)
+		return;
+
+	for (uint8_t i = 0; i < count; i++)
+		devices[i]->hw->drive_RESET(devices[i]->context, 0);  //Reset pin low
+	devices[0]->hw->msDelay(1);                                   //1ms delay
+	for (uint8_t i = 0; i < count; i++)
+		devices[i]->hw->drive_RESET(devices[i]->context, 1);  //Reset pin high
+	devices[0]->hw->msDelay(50);                                  //50ms delay
+
+	for (uint8_t i = 0; i < count; i++)
+		SSD1322_API_command_sequence(devices[i], init_sequence, sizeof(init_sequence));
+	devices[0]->hw->msDelay(10);                                  //stabilize VDD
+
+	for (uint8_t i = 0; i < count; i++)
+		SSD1322_API_command(devices[i], SLEEP_MODE_OFF);         //display on
+	devices[0]->hw->msDelay(50);                                  //stabilize VDD
 }
 
 //====================== normal/inversion ========================//
@@ -102,61 +155,98 @@ void SSD1322_API_init()
  *  When mode is set to ON or OFF, display ignores GRAM data and is always on or off.
  */
 
-void SSD1322_API_set_display_mode(enum SSD1322_mode_e mode)
+void SSD1322_API_set_display_mode(SSD1322_device_t *device, enum SSD1322_mode_e mode)
 {
 	switch (mode)
 	{
 	case SSD1322_MODE_NORMAL:
-		SSD1322_API_command(SET_DISP_MODE_NORMAL);
+		SSD1322_API_command(device, SET_DISP_MODE_NORMAL);
 		break;
 	case SSD1322_MODE_INVERTED:
-		SSD1322_API_command(SET_DISP_MODE_INVERTED);
+		SSD1322_API_command(device, SET_DISP_MODE_INVERTED);
 		break;
 	case SSD1322_MODE_ON:
-		SSD1322_API_command(SET_DISP_MODE_ON);
+		SSD1322_API_command(device, SET_DISP_MODE_ON);
 		break;
 	case SSD1322_MODE_OFF:
-		SSD1322_API_command(SET_DISP_MODE_OFF);
+		SSD1322_API_command(device, SET_DISP_MODE_OFF);
+		break;
+	}
+}
+
+//====================== orientation ========================//
+/**
+ *  @brief Rotates or mirrors picture using display controller remap register.
+ *
+ *  Frame buffer content is not changed and no additional work is needed when drawing,
+ *  so this is the preferred way to handle displays mounted upside down. Frame buffer
+ *  has to be sent again after the change, because GRAM is read in a different order.
+ *
+ *  @param[in] device
+ *             display to change
+ *  @param[in] orientation
+ *             normal, rotated by 180 degrees, mirrored horizontally or mirrored vertically
+ */
+void SSD1322_API_set_orientation(SSD1322_device_t *device, enum SSD1322_orientation_e orientation)
+{
+	uint8_t remap = REMAP_DEFAULT;
+
+	switch (orientation)
+	{
+	case SSD1322_ORIENTATION_NORMAL:
+		break;
+	case SSD1322_ORIENTATION_ROTATED_180:
+		remap ^= REMAP_COLUMN_ADDR | REMAP_COM_SCAN;
+		break;
+	case SSD1322_ORIENTATION_MIRROR_X:
+		remap ^= REMAP_COLUMN_ADDR;
+		break;
+	case SSD1322_ORIENTATION_MIRROR_Y:
+		remap ^= REMAP_COM_SCAN;
 		break;
 	}
+
+	SSD1322_API_command(device, SET_REMAP_AND_DUAL_COM);
+	SSD1322_API_data(device, remap);
+	SSD1322_API_data(device, REMAP_DUAL_COM);
 }
 
 //====================== go to sleep ========================//
 /**
  *  @brief Go to sleep mode.
  */
-void SSD1322_API_sleep_on()
+void SSD1322_API_sleep_on(SSD1322_device_t *device)
 {
-	SSD1322_API_command(SLEEP_MODE_ON);
+	SSD1322_API_command(device, SLEEP_MODE_ON);
 }
 
 //====================== wake up from sleep ========================//
 /**
  *  @brief Wake up from sleep mode.
  */
-void SSD1322_API_sleep_off()
+void SSD1322_API_sleep_off(SSD1322_device_t *device)
 {
-	SSD1322_API_command(SLEEP_MODE_OFF);
+	SSD1322_API_command(device, SLEEP_MODE_OFF);
 }
 
 //====================== contrast ========================//
 /**
  *  @brief Sets contrast between brightest and darkest pixels.
  */
-void SSD1322_API_set_contrast(uint8_t contrast)
+void SSD1322_API_set_contrast(SSD1322_device_t *device, uint8_t contrast)
 {
-	SSD1322_API_command(SET_CONTRAST_CURRENT);
-	SSD1322_API_data(contrast);
+	SSD1322_API_command(device, SET_CONTRAST_CURRENT);
+	SSD1322_API_data(device, contrast);
 }
 
 //====================== brightness ========================//
 /**
  *  @brief Should set brightness, but actual effect is similar to setting contrast.
  */
-void SSD1322_API_set_brightness(uint8_t brightness)
+void SSD1322_API_set_brightness(SSD1322_device_t *device, uint8_t brightness)
 {
-	SSD1322_API_command(MASTER_CONTRAST_CURRENT);
-	SSD1322_API_data(0x0F & brightness);            //first 4 bits have to be 0
+	SSD1322_API_command(device, MASTER_CONTRAST_CURRENT);
+	SSD1322_API_data(device, 0x0F & brightness);            //first 4 bits have to be 0
 }
 
 //====================== custom grayscale ========================//
@@ -170,20 +260,21 @@ void SSD1322_API_set_brightness(uint8_t brightness)
  *
  *  Where Gx is value of grayscale level
  *
+ *  @param[in] device display to change
  *  @param[in] grayscale_tab array of 16 brightness values
  *
  *  @return 0 when levels are out of range, 1 if function has ended correctly
  */
-uint8_t SSD1322_API_custom_grayscale(uint8_t *grayscale_tab)
+uint8_t SSD1322_API_custom_grayscale(SSD1322_device_t *device, uint8_t *grayscale_tab)
 {
-	SSD1322_API_command(SET_GRAYSCALE_TABLE);
+	SSD1322_API_command(device, SET_GRAYSCALE_TABLE);
 	for(int i = 0; i < 16; i++)
 	{
 		if(grayscale_tab[i] > 180)
 			return 0;
-		SSD1322_API_data(grayscale_tab[i]);
+		SSD1322_API_data(device, grayscale_tab[i]);
 	}
-	SSD1322_API_command(ENABLE_GRAYSCALE_TABLE);
+	SSD1322_API_command(device, ENABLE_GRAYSCALE_TABLE);
 	return 1;
 }
 
@@ -191,28 +282,29 @@ uint8_t SSD1322_API_custom_grayscale(uint8_t *grayscale_tab)
 /**
  *  @brief Reset grayscale levels to default (linear)
  */
-void SSD1322_API_default_grayscale()
+void SSD1322_API_default_grayscale(SSD1322_device_t *device)
 {
-	SSD1322_API_command(SET_DEFAULT_GRAYSCALE_TAB);
+	SSD1322_API_command(device, SET_DEFAULT_GRAYSCALE_TAB);
 }
 
 //====================== window to draw into ========================//
 /**
  *  @brief Sets range of pixels to write to.
  *
+ *  @param[in] device
  *  @param[in] start_column
  *  @param[in] end_column
  *  @param[in] start_row
  *  @param[in] end_row
  */
-void SSD1322_API_set_window(uint8_t start_column, uint8_t end_column, uint8_t start_row, uint8_t end_row)
+void SSD1322_API_set_window(SSD1322_device_t *device, uint8_t start_column, uint8_t end_column, uint8_t start_row, uint8_t end_row)
 {
-	SSD1322_API_command(SET_COLUMN_ADDR);  //set columns range
-	SSD1322_API_data(28+start_column);
-	SSD1322_API_data(28+end_column);
-	SSD1322_API_command(SET_ROW_ADDR);  //set rows range
-	SSD1322_API_data(start_row);
-	SSD1322_API_data(end_row);
+	SSD1322_API_command(device, SET_COLUMN_ADDR);  //set columns range
+	SSD1322_API_data(device, 28+start_column);
+	SSD1322_API_data(device, 28+end_column);
+	SSD1322_API_command(device, SET_ROW_ADDR);  //set rows range
+	SSD1322_API_data(device, start_row);
+	SSD1322_API_data(device, end_row);
 }
 
 //====================== send pixel data to display ========================//
@@ -221,14 +313,31 @@ void SSD1322_API_set_window(uint8_t start_column, uint8_t end_column, uint8_t st
  *
  *  This function should be always preceded by SSD1322_API_set_window() to specify range of rows and columns.
  *
+ *  @param[in] device display to send pixels to
  *  @param[in] buffer array of pixel values
  *  @param[in] buffer_size amount of bytes in the array
  */
-void SSD1322_API_send_buffer(uint8_t* buffer, uint32_t buffer_size)
+void SSD1322_API_send_buffer(SSD1322_device_t *device, const uint8_t* buffer, uint32_t buffer_size)
+{
+	SSD1322_API_command(device, ENABLE_RAM_WRITE);  //enable write of pixels
+	SSD1322_API_data_array(device, buffer, buffer_size);
+}
+
+//====================== send pixel data without RAM write command ========================//
+/**
+ *  @brief Sends array of data bytes to SSD1322 without issuing RAM write command.
+ *
+ *  Used to continue a transfer started by SSD1322_API_send_buffer() or by ENABLE_RAM_WRITE command,
+ *  for example when window is filled row by row from a frame buffer that is wider than the window.
+ *
+ *  @param[in] device display to send data to
+ *  @param[in] data array of bytes to send
+ *  @param[in] data_size amount of bytes in the array
+ */
+void SSD1322_API_data_array(SSD1322_device_t *device, const uint8_t* data, uint32_t data_size)
 {
-	SSD1322_API_command(ENABLE_RAM_WRITE);  //enable write of pixels
-	SSD1322_HW_drive_CS_low();
-	SSD1322_HW_drive_DC_high();
-	SSD1322_HW_SPI_send_array(buffer, buffer_size);
-	SSD1322_HW_drive_CS_high();
+	device->hw->drive_CS(device->context, 0);
+	device->hw->drive_DC(device->context, 1);
+	device->hw->SPI_send_array(device->context, data, data_size);
+	device->hw->drive_CS(device->context, 1);
 }
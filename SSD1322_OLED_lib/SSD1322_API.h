@@ -64,6 +64,14 @@ extern "C" {
 #define VERTICAL_AND_RIGHT_HORIZONTAL_SCROLL 0x29
 #define VERTICAL_AND_LEFT_HORIZONTAL_SCROLL 0x2A
 
+/*============ Remap register (0xA0) bits ============*/
+
+#define REMAP_COLUMN_ADDR          0x02    //reverse order of columns
+#define REMAP_NIBBLE               0x04    //reverse order of pixels in a column
+#define REMAP_COM_SCAN             0x10    //scan rows from bottom to top
+#define REMAP_DEFAULT              0x14    //remap used by initialization sequence
+#define REMAP_DUAL_COM             0x11    //second byte of remap command - dual COM line mode enabled (bit 4)
+
 /*============ SSD1322 enums ============*/
 
 enum SSD1322_mode_e
@@ -71,25 +79,34 @@ enum SSD1322_mode_e
 	SSD1322_MODE_ON, SSD1322_MODE_OFF, SSD1322_MODE_NORMAL, SSD1322_MODE_INVERTED
 };
 
+enum SSD1322_orientation_e
+{
+	SSD1322_ORIENTATION_NORMAL, SSD1322_ORIENTATION_ROTATED_180, SSD1322_ORIENTATION_MIRROR_X, SSD1322_ORIENTATION_MIRROR_Y
+};
+
 /*============ SSD1322 API functions ============*/
 
-void SSD1322_API_command(uint8_t command);
-void SSD1322_API_data(uint8_t data);
+void SSD1322_API_command(SSD1322_device_t *device, uint8_t command);
+void SSD1322_API_data(SSD1322_device_t *device, uint8_t data);
+void SSD1322_API_command_sequence(SSD1322_device_t *device, const uint8_t *sequence, uint32_t sequence_size);
 
-void SSD1322_API_init();
-void SSD1322_API_set_display_mode(enum SSD1322_mode_e mode);
+void SSD1322_API_init(SSD1322_device_t *device);
+void SSD1322_API_init_devices(SSD1322_device_t **devices, uint8_t count);
+void SSD1322_API_set_display_mode(SSD1322_device_t *device, enum SSD1322_mode_e mode);
+void SSD1322_API_set_orientation(SSD1322_device_t *device, enum SSD1322_orientation_e orientation);
 
-void SSD1322_API_sleep_on();
-void SSD1322_API_sleep_off();
+void SSD1322_API_sleep_on(SSD1322_device_t *device);
+void SSD1322_API_sleep_off(SSD1322_device_t *device);
 
-void SSD1322_API_set_contrast(uint8_t contrast);
-void SSD1322_API_set_brightness(uint8_t brightness);
+void SSD1322_API_set_contrast(SSD1322_device_t *device, uint8_t contrast);
+void SSD1322_API_set_brightness(SSD1322_device_t *device, uint8_t brightness);
 
-uint8_t SSD1322_API_custom_grayscale(uint8_t* grayscale_tab);
-void SSD1322_API_default_grayscale();
+uint8_t SSD1322_API_custom_grayscale(SSD1322_device_t *device, uint8_t* grayscale_tab);
+void SSD1322_API_default_grayscale(SSD1322_device_t *device);
 
-void SSD1322_API_set_window(uint8_t start_column, uint8_t end_column, uint8_t start_row, uint8_t end_row);
-void SSD1322_API_send_buffer(uint8_t* buffer, uint32_t buffer_size);
+void SSD1322_API_set_window(SSD1322_device_t *device, uint8_t start_column, uint8_t end_column, uint8_t start_row, uint8_t end_row);
+void SSD1322_API_send_buffer(SSD1322_device_t *device, const uint8_t* buffer, uint32_t buffer_size);
+void SSD1322_API_data_array(SSD1322_device_t *device, const uint8_t* data, uint32_t data_size);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,412 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Anim.c
+ *
+ * \brief Delta encoded animations played directly into frame buffer.
+ *
+ * Every frame stream starts with frame type byte.
+ *
+ * ANIM_FRAME_KEY stream contains whole clip in frame buffer format (4 bits per pixel),
+ * each row is RLE encoded separately.
+ *
+ * ANIM_FRAME_DELTA stream contains 16-bit little endian amount of spans, then spans:
+ *   - row of the clip (1 byte)
+ *   - first byte of the span in clip row (1 byte)
+ *   - span length in bytes (1 byte)
+ *   - RLE encoded bytes that are XORed with frame buffer content
+ *
+ * RLE token is a single byte. Values 0x00-0x7F are followed by (token + 1) literal bytes,
+ * values 0x80-0xFF are followed by one byte repeated ((token & 0x7F) + 1) times.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_API.h"
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Anim.h"
+
+#include <string.h>
+
+#define ANIM_SPAN_GAP  4    //unchanged bytes that are still merged into one span by encoder
+#define ANIM_RLE_MAX   128  //max amount of bytes coded by one RLE token
+
+//====================== decode RLE ========================//
+/**
+ *  @brief Decodes RLE tokens to destination array, copying or XORing bytes.
+ *
+ *  @return pointer to first byte after decoded tokens
+ */
+static const uint8_t *rle_decode(const uint8_t *src, uint8_t *dst, uint16_t length, uint8_t xor_mode)
+{
+	while (length)
+	{
+		uint8_t token = *src++;
+		uint16_t count = (token & 0x7F) + 1;
+		if (count > length)
+			count = length;
+		length -= count;
+
+		if (token & 0x80)
+		{
+			uint8_t value = *src++;
+			if (xor_mode)
+			{
+				while (count--)
+					*dst++ ^= value;
+			}
+			else
+			{
+				memset(dst, value, count);
+				dst += count;
+			}
+		}
+		else
+		{
+			if (xor_mode)
+			{
+				while (count--)
+					*dst++ ^= *src++;
+			}
+			else
+			{
+				memcpy(dst, src, count);
+				dst += count;
+				src += count;
+			}
+		}
+	}
+	return src;
+}
+
+//====================== encode RLE ========================//
+/**
+ *  @brief Encodes array with RLE tokens.
+ *
+ *  @return amount of bytes written to out or 0 if they did not fit
+ */
+static uint32_t rle_encode(const uint8_t *src, uint16_t length, uint8_t *out, uint32_t out_size)
+{
+	uint32_t out_pos = 0;
+	uint16_t i = 0;
+
+	while (i < length)
+	{
+		uint16_t run = 1;
+		while (i + run < length && run < ANIM_RLE_MAX && src[i + run] == src[i])
+			run++;
+
+		if (run >= 3)
+		{
+			if (out_pos + 2 > out_size)
+				return 0;
+			out[out_pos++] = 0x80 | (run - 1);
+			out[out_pos++] = src[i];
+			i += run;
+			continue;
+		}
+
+		//collect literal bytes until next run of at least 3 bytes
+		uint16_t literal = 0;
+		while (i + literal < length && literal < ANIM_RLE_MAX)
+		{
+			uint16_t j = i + literal;
+			if (j + 2 < length && src[j] == src[j + 1] && src[j] == src[j + 2])
+				break;
+			literal++;
+		}
+		if (out_pos + 1 + literal > out_size)
+			return 0;
+		out[out_pos++] = literal - 1;
+		memcpy(out + out_pos, src + i, literal);
+		out_pos += literal;
+		i += literal;
+	}
+	return out_pos;
+}
+
+//====================== apply frame ========================//
+/**
+ *  @brief Applies frame stream to frame buffer and optionally sends changed areas to OLED.
+ *
+ *  Changed rows that are adjacent are merged into one window, so each window
+ *  costs only one set_window command.
+ */
+static void apply_frame(GFXanim_player *player, uint16_t frame, uint8_t upload)
+{
+	const GFXanim *anim = player->anim;
+	const uint8_t *src = anim->frames[frame];
+	uint16_t stride = player->canvas->stride;
+	uint16_t row_bytes = anim->width / 2;
+	uint8_t *clip = player->canvas->buffer + player->y * stride + player->x / 2;
+
+	if (*src++ == ANIM_FRAME_KEY)
+	{
+		for (uint16_t i = 0; i < anim->height; i++)
+		{
+			src = rle_decode(src, clip + i * stride, row_bytes, 0);
+		}
+		if (upload)
+			send_rect_to_OLED(player->canvas, player->x, player->y, player->x + anim->width - 1, player->y + anim->height - 1);
+		return;
+	}
+
+	uint16_t span_count = src[0] | (src[1] << 8);
+	src += 2;
+
+	uint8_t band_open = 0;
+	uint16_t band_y0 = 0, band_y1 = 0, band_b0 = 0, band_b1 = 0;
+
+	while (span_count--)
+	{
+		uint8_t row = src[0];
+		uint8_t start = src[1];
+		uint8_t length = src[2];
+		src += 3;
+		src = rle_decode(src, clip + row * stride + start, length, 1);
+
+		if (!upload)
+			continue;
+
+		if (band_open && row >= band_y0 && row <= band_y1 + 1)
+		{
+			band_y1 = row;
+			if (start < band_b0)
+				band_b0 = start;
+			if (start + length - 1 > band_b1)
+				band_b1 = start + length - 1;
+		}
+		else
+		{
+			if (band_open)
+				send_rect_to_OLED(player->canvas, player->x + band_b0 * 2, player->y + band_y0, player->x + band_b1 * 2 + 1, player->y + band_y1);
+			band_open = 1;
+			band_y0 = band_y1 = row;
+			band_b0 = start;
+			band_b1 = start + length - 1;
+		}
+	}
+	if (band_open)
+		send_rect_to_OLED(player->canvas, player->x + band_b0 * 2, player->y + band_y0, player->x + band_b1 * 2 + 1, player->y + band_y1);
+}
+
+//====================== init animation player ========================//
+/**
+ *  @brief Prepares animation player and shows first frame of the clip.
+ *
+ *  First frame is written to frame buffer and sent to OLED. Frame buffer has to stay
+ *  displayed without offset (like after send_buffer_to_OLED(canvas, 0, 0)),
+ *  because player sends only changed areas.
+ *
+ *  If the clip does not fit in frame buffer, player is left empty and does nothing.
+ *
+ *  @param[in] player
+ *             player state
+ *  @param[in] anim
+ *             animation clip
+ *  @param[in] canvas
+ *             canvas with frame buffer that clip is drawn into, its rotation and clipping are not used
+ *  @param[in] x
+ *             x position of top left clip corner, odd values are rounded down
+ *  @param[in] y
+ *             y position of top left clip corner
+ */
+void anim_player_init(GFXanim_player *player, const GFXanim *anim, GFXcanvas *canvas, uint16_t x, uint16_t y)
+{
+	player->anim = NULL;
+	player->canvas = canvas;
+	player->x = x & ~1;
+	player->y = y;
+	player->frame = 0;
+
+	if (anim->frame_count == 0 || player->x + anim->width > canvas->width || y + anim->height > canvas->height)
+		return;
+
+	player->anim = anim;
+	apply_frame(player, 0, 1);
+}
+
+//====================== play next frame ========================//
+/**
+ *  @brief Applies next frame of animation and sends changed areas to OLED.
+ *
+ *  After the last frame playback starts again from the first one.
+ *
+ *  @param[in] player
+ *             player state
+ *
+ *  @return index of displayed frame
+ */
+uint16_t anim_player_next(GFXanim_player *player)
+{
+	if (player->anim == NULL)
+		return 0;
+
+	uint16_t next = player->frame + 1;
+	if (next >= player->anim->frame_count)
+		next = 0;
+
+	apply_frame(player, next, 1);
+	player->frame = next;
+	return next;
+}
+
+//====================== jump to frame ========================//
+/**
+ *  @brief Shows selected frame of animation.
+ *
+ *  Nearest preceding keyframe and all deltas after it are applied to frame buffer,
+ *  then whole clip is sent to OLED once.
+ *
+ *  @param[in] player
+ *             player state
+ *  @param[in] frame
+ *             index of frame to show
+ */
+void anim_player_seek(GFXanim_player *player, uint16_t frame)
+{
+	const GFXanim *anim = player->anim;
+	if (anim == NULL || frame >= anim->frame_count)
+		return;
+
+	uint16_t key = frame;
+	while (key > 0 && anim->frames[key][0] != ANIM_FRAME_KEY)
+		key--;
+
+	for (uint16_t i = key; i <= frame; i++)
+	{
+		apply_frame(player, i, 0);
+	}
+	player->frame = frame;
+	send_rect_to_OLED(player->canvas, player->x, player->y, player->x + anim->width - 1, player->y + anim->height - 1);
+}
+
+//====================== encode keyframe ========================//
+/**
+ *  @brief Encodes whole frame as a keyframe stream.
+ *
+ *  Meant to be used on PC or on MCU to prepare animation data from frames
+ *  in frame buffer format (4 bits per pixel, rows of width/2 bytes).
+ *
+ *  @param[in] frame
+ *             frame pixels
+ *  @param[in] width
+ *             frame width in pixels
+ *  @param[in] height
+ *             frame height in pixels
+ *  @param[out] out
+ *             array for encoded stream
+ *  @param[in] out_size
+ *             size of out array
+ *
+ *  @return size of encoded stream, 0 if it did not fit in out array
+ */
+uint32_t anim_encode_key(const uint8_t *frame, uint16_t width, uint16_t height, uint8_t *out, uint32_t out_size)
+{
+	uint16_t row_bytes = width / 2;
+	uint32_t out_pos = 1;
+
+	if (out_size < 1)
+		return 0;
+	out[0] = ANIM_FRAME_KEY;
+
+	for (uint16_t i = 0; i < height; i++)
+	{
+		uint32_t written = rle_encode(frame + i * row_bytes, row_bytes, out + out_pos, out_size - out_pos);
+		if (written == 0)
+			return 0;
+		out_pos += written;
+	}
+	return out_pos;
+}
+
+//====================== encode delta frame ========================//
+/**
+ *  @brief Encodes differences between two frames as a delta stream.
+ *
+ *  Changed bytes closer than a few bytes from each other are joined into one span,
+ *  because every span costs 3 bytes of header and one more window to send.
+ *  If delta stream is bigger than keyframe, anim_encode_key() should be used instead.
+ *
+ *  @param[in] prev
+ *             previous frame pixels
+ *  @param[in] next
+ *             next frame pixels
+ *  @param[in] width
+ *             frame width in pixels
+ *  @param[in] height
+ *             frame height in pixels
+ *  @param[out] out
+ *             array for encoded stream
+ *  @param[in] out_size
+ *             size of out array
+ *
+ *  @return size of encoded stream, 0 if it did not fit in out array
+ */
+uint32_t anim_encode_delta(const uint8_t *prev, const uint8_t *next, uint16_t width, uint16_t height, uint8_t *out, uint32_t out_size)
+{
+	uint16_t row_bytes = width / 2;
+	uint16_t span_count = 0;
+	uint32_t out_pos = 3;
+	uint8_t xor_bytes[255];
+
+	if (out_size < 3)
+		return 0;
+	out[0] = ANIM_FRAME_DELTA;
+
+	for (uint16_t i = 0; i < height; i++)
+	{
+		const uint8_t *p = prev + i * row_bytes;
+		const uint8_t *n = next + i * row_bytes;
+		uint16_t j = 0;
+
+		while (j < row_bytes)
+		{
+			if (p[j] == n[j])
+			{
+				j++;
+				continue;
+			}
+
+			//span starts at first changed byte and ends after ANIM_SPAN_GAP unchanged bytes
+			uint16_t start = j;
+			uint16_t end = j;
+			while (j < row_bytes && j - start < 255)
+			{
+				if (p[j] != n[j])
+					end = j;
+				else if (j - end >= ANIM_SPAN_GAP)
+					break;
+				j++;
+			}
+
+			uint16_t length = end - start + 1;
+			for (uint16_t k = 0; k < length; k++)
+			{
+				xor_bytes[k] = p[start + k] ^ n[start + k];
+			}
+
+			if (out_pos + 3 > out_size)
+				return 0;
+			out[out_pos++] = i;
+			out[out_pos++] = start;
+			out[out_pos++] = length;
+
+			uint32_t written = rle_encode(xor_bytes, length, out + out_pos, out_size - out_pos);
+			if (written == 0)
+				return 0;
+			out_pos += written;
+			span_count++;
+			j = end + 1;
+		}
+	}
+
+	out[1] = span_count & 0xFF;
+	out[2] = span_count >> 8;
+	return out_pos;
+}
@@ -0,0 +1,67 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Anim.h
+ *
+ * \brief Delta encoded animations played directly into frame buffer.
+ *
+ * Animation is stored as a list of frames. Keyframes contain whole clip, other frames
+ * contain only XOR deltas of bytes that changed since previous frame. Player applies
+ * deltas to frame buffer and sends only changed areas to OLED.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_ANIM_H
+#define SSD1322_ANIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+
+/*============ defines ============*/
+
+#define ANIM_FRAME_KEY    0x00     //frame stream contains whole clip
+#define ANIM_FRAME_DELTA  0x01     //frame stream contains XOR deltas to previous frame
+
+/*============ animation structures ============*/
+
+// Animation clip stored in flash
+typedef struct {
+  uint16_t width;                  ///< Clip width in pixels, has to be even (max 510)
+  uint16_t height;                 ///< Clip height in pixels (max 256)
+  uint16_t frame_count;            ///< Amount of frames in clip
+  const uint8_t *const *frames;    ///< Encoded frame streams, first one has to be a keyframe
+} GFXanim;
+
+// Animation playback state
+typedef struct {
+  const GFXanim *anim;             ///< Played clip
+  GFXcanvas *canvas;               ///< Canvas that clip is drawn into
+  uint16_t x;                      ///< x position of top left clip corner, has to be even
+  uint16_t y;                      ///< y position of top left clip corner
+  uint16_t frame;                  ///< Index of frame currently held in frame buffer
+} GFXanim_player;
+
+/*============ functions ============*/
+
+void anim_player_init(GFXanim_player *player, const GFXanim *anim, GFXcanvas *canvas, uint16_t x, uint16_t y);
+uint16_t anim_player_next(GFXanim_player *player);
+void anim_player_seek(GFXanim_player *player, uint16_t frame);
+
+uint32_t anim_encode_key(const uint8_t *frame, uint16_t width, uint16_t height, uint8_t *out, uint32_t out_size);
+uint32_t anim_encode_delta(const uint8_t *prev, const uint8_t *next, uint16_t width, uint16_t height, uint8_t *out, uint32_t out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_ANIM_H */
@@ -0,0 +1,167 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Assets.hpp
+ *
+ * \brief Compile-time conversion of 8 bits per pixel bitmaps to 4 bits per pixel (C++14 or newer).
+ *
+ * Converted bitmap is a constexpr object, so it is placed in flash next to the program
+ * and only the converted copy is linked. Source array has to be constexpr too:
+ *
+ *   constexpr uint8_t krecik[64 * 64] = { ... };
+ *   constexpr auto krecik_4bpp = SSD1322::convert_8bpp<64>(krecik, SSD1322::Dither::floyd_steinberg);
+ *   draw_bitmap_4bpp(&canvas, krecik_4bpp.data, 0, 0, krecik_4bpp.width, krecik_4bpp.height);
+ *
+ * With C++20 conversion functions are consteval and can never be run on MCU by mistake.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_ASSETS_HPP
+#define SSD1322_ASSETS_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if __cplusplus < 201402L
+#error "SSD1322_Assets.hpp needs C++14 or newer"
+#endif
+
+#if __cplusplus >= 202002L
+#define SSD1322_CONSTEVAL consteval
+#else
+#define SSD1322_CONSTEVAL constexpr
+#endif
+
+namespace SSD1322
+{
+
+// Reduction of 8-bit brightness to 4 bits
+enum class Dither
+{
+	none,             ///< Lower 4 bits are cut off, same as draw_bitmap_8bpp()
+	ordered,          ///< 4x4 Bayer matrix, no error spreading, good for animations
+	floyd_steinberg,  ///< Error diffusion, best for photos
+	sierra_lite       ///< Lighter error diffusion, same as DITHER_SIERRA_LITE of SSD1322_Dither
+};
+
+// Bitmap in draw_bitmap_4bpp() format, for even width rows are also frame buffer rows
+template<uint16_t W, uint16_t H>
+struct Bitmap4bpp
+{
+	static constexpr uint16_t width = W;
+	static constexpr uint16_t height = H;
+	static constexpr uint32_t size = ((uint32_t)W * H + 1) / 2;
+
+	uint8_t data[size];
+};
+
+namespace detail
+{
+
+//====================== quantize pixel ========================//
+/**
+ *  @brief Reduces 8-bit value (with accumulated error) to the nearest of 16 levels 0, 17, ... 255.
+ */
+constexpr uint8_t nearest_level(int16_t value)
+{
+	if (value <= 0)
+		return 0;
+	if (value >= 255)
+		return 15;
+	return (value + 8) / 17;
+}
+
+//====================== convert ========================//
+template<uint16_t W, uint16_t H>
+constexpr Bitmap4bpp<W, H> convert(const uint8_t *src, uint16_t src_width, uint16_t x0, uint16_t y0, Dither dither)
+{
+	constexpr uint8_t bayer[4][4] = { { 0, 8, 2, 10 }, { 12, 4, 14, 6 }, { 3, 11, 1, 9 }, { 15, 7, 13, 5 } };
+
+	Bitmap4bpp<W, H> out {};
+	int16_t error[2][W + 2] {};    //errors of current and next row, shifted by one for x - 1
+	uint32_t pixel = 0;
+
+	for (uint16_t y = 0; y < H; y++)
+	{
+		int16_t *current = error[y % 2];
+		int16_t *next = error[(y + 1) % 2];
+		for (uint16_t x = 0; x < W + 2; x++)
+			next[x] = 0;
+
+		for (uint16_t x = 0; x < W; x++)
+		{
+			int16_t value = src[(uint32_t)(y0 + y) * src_width + x0 + x];
+			uint8_t level = value >> 4;
+
+			if (dither == Dither::ordered)
+			{
+				//threshold moves value by -0.5 to +0.5 of a level step
+				level = nearest_level(value + (bayer[y % 4][x % 4] * 17 + 8) / 16 - 8);
+			}
+			else if (dither == Dither::floyd_steinberg)
+			{
+				value += current[x + 1];
+				level = nearest_level(value);
+				int16_t diff = value - level * 17;
+				current[x + 2] += diff * 7 / 16;
+				next[x] += diff * 3 / 16;
+				next[x + 1] += diff * 5 / 16;
+				next[x + 2] += diff / 16;
+			}
+			else if (dither == Dither::sierra_lite)
+			{
+				value += current[x + 1];
+				level = nearest_level(value);
+				int16_t diff = value - level * 17;
+				current[x + 2] += diff * 2 / 4;
+				next[x] += diff / 4;
+				next[x + 1] += diff / 4;
+			}
+
+			if (pixel % 2 == 0)
+				out.data[pixel / 2] = level << 4;
+			else
+				out.data[pixel / 2] |= level;
+			pixel++;
+		}
+	}
+	return out;
+}
+
+}
+
+//====================== convert whole bitmap ========================//
+/**
+ *  @brief Converts 8 bits per pixel bitmap to 4 bits per pixel at compile time.
+ *
+ *  Height is computed from array size and width.
+ */
+template<uint16_t SrcW, size_t N>
+SSD1322_CONSTEVAL Bitmap4bpp<SrcW, N / SrcW> convert_8bpp(const uint8_t (&src)[N], Dither dither = Dither::none)
+{
+	static_assert(N % SrcW == 0, "array size is not a multiple of bitmap width");
+	return detail::convert<SrcW, N / SrcW>(src, SrcW, 0, 0, dither);
+}
+
+//====================== convert part of bitmap ========================//
+/**
+ *  @brief Crops 8 bits per pixel bitmap and converts the cropped part to 4 bits per pixel at compile time.
+ *
+ *  Crop rectangle starts at (X, Y) and is W x H pixels big. It has to lie inside source bitmap.
+ */
+template<uint16_t SrcW, uint16_t X, uint16_t Y, uint16_t W, uint16_t H, size_t N>
+SSD1322_CONSTEVAL Bitmap4bpp<W, H> crop_8bpp(const uint8_t (&src)[N], Dither dither = Dither::none)
+{
+	static_assert(N % SrcW == 0, "array size is not a multiple of bitmap width");
+	static_assert(X + W <= SrcW && Y + H <= N / SrcW, "crop rectangle is outside of bitmap");
+	return detail::convert<W, H>(src, SrcW, X, Y, dither);
+}
+
+}
+
+#endif /* SSD1322_ASSETS_HPP */
@@ -0,0 +1,312 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Bus.c
+ *
+ * \brief Transfer scheduler for several SSD1322 displays sharing one SPI bus.
+ *
+ * Each display has its own CS pin, so transfers for different displays can be freely
+ * interleaved. SSD1322 keeps RAM write mode while its CS is high, so a frame can be
+ * sent in chunks with commands for other displays in between.
+ *
+ * Jobs of one display are always sent in order they were queued. Between displays,
+ * scheduler goes round robin and sends one command or one chunk of pixel data per turn.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_API.h"
+#include "../SSD1322_OLED_lib/SSD1322_Bus.h"
+
+#include <string.h>
+
+//====================== init bus ========================//
+/**
+ *  @brief Prepares empty job queue.
+ *
+ *  @param[in] bus
+ *             bus to prepare
+ *  @param[in] jobs
+ *             array for queued jobs, has to stay valid as long as bus is used
+ *  @param[in] size
+ *             amount of jobs that fit in array
+ *  @param[in] chunk_size
+ *             max amount of pixel data bytes sent to one display at once, 0 for BUS_DEFAULT_CHUNK_SIZE
+ */
+void SSD1322_bus_init(SSD1322_bus_t *bus, SSD1322_bus_job_t *jobs, uint8_t size, uint32_t chunk_size)
+{
+	bus->jobs = jobs;
+	bus->size = size;
+	bus->count = 0;
+	bus->next = 0;
+	bus->active = 0;
+	bus->busy = 0;
+	bus->chunk_size = chunk_size ? chunk_size : BUS_DEFAULT_CHUNK_SIZE;
+}
+
+//====================== job commands ========================//
+/**
+ *  @brief Returns commands of a job. Window jobs keep them inside job, so they move with it.
+ */
+static const uint8_t *job_commands(const SSD1322_bus_job_t *job)
+{
+	return job->commands ? job->commands : job->window;
+}
+
+//====================== add job ========================//
+/**
+ *  @brief Appends job to queue.
+ *
+ *  @return pointer to added job or NULL if queue is full
+ */
+static SSD1322_bus_job_t *add_job(SSD1322_bus_t *bus, SSD1322_device_t *device, void (*done)(void *arg), void *arg)
+{
+	if (bus->count >= bus->size)
+		return NULL;
+
+	SSD1322_bus_job_t *job = &bus->jobs[bus->count];
+	job->device = device;
+	job->commands = NULL;
+	job->commands_size = 0;
+	job->data = NULL;
+	job->data_size = 0;
+	job->done = done;
+	job->arg = arg;
+	job->commands_pos = 0;
+	job->data_pos = 0;
+	return job;
+}
+
+//====================== queue commands ========================//
+/**
+ *  @brief Queues commands for one display.
+ *
+ *  Commands array is not copied and has to stay unchanged until done callback is called.
+ *  Queue functions must not be interrupted by SSD1322_bus_transfer_done(), so when
+ *  non blocking transfers are used, SPI interrupt should be disabled for the call.
+ *
+ *  @param[in] bus
+ *             bus shared by displays
+ *  @param[in] device
+ *             display to send commands to
+ *  @param[in] commands
+ *             commands, each given as command byte, amount of parameters and parameters
+ *  @param[in] commands_size
+ *             size of commands array in bytes
+ *  @param[in] done
+ *             function called when all commands were sent or NULL
+ *  @param[in] arg
+ *             passed to done function
+ *
+ *  @return 1 if job was queued, 0 if queue is full
+ */
+uint8_t SSD1322_bus_queue_commands(SSD1322_bus_t *bus, SSD1322_device_t *device, const uint8_t *commands, uint32_t commands_size,
+		void (*done)(void *arg), void *arg)
+{
+	SSD1322_bus_job_t *job = add_job(bus, device, done, arg);
+	if (job == NULL)
+		return 0;
+
+	job->commands = commands;
+	job->commands_size = commands_size;
+	bus->count++;
+	return 1;
+}
+
+//====================== queue window ========================//
+/**
+ *  @brief Queues pixel data to be written to a window of one display.
+ *
+ *  Window is given like for SSD1322_API_set_window(). Data has to be contiguous, for example
+ *  whole frame buffer or full width rows of it, and has to stay unchanged until done callback
+ *  is called.
+ *
+ *  @param[in] bus
+ *             bus shared by displays
+ *  @param[in] device
+ *             display to send pixels to
+ *  @param[in] start_column
+ *  @param[in] end_column
+ *  @param[in] start_row
+ *  @param[in] end_row
+ *  @param[in] data
+ *             pixel values
+ *  @param[in] data_size
+ *             amount of bytes in data array
+ *  @param[in] done
+ *             function called when all pixels were sent or NULL
+ *  @param[in] arg
+ *             passed to done function
+ *
+ *  @return 1 if job was queued, 0 if queue is full
+ */
+uint8_t SSD1322_bus_queue_window(SSD1322_bus_t *bus, SSD1322_device_t *device, uint8_t start_column, uint8_t end_column,
+		uint8_t start_row, uint8_t end_row, const uint8_t *data, uint32_t data_size, void (*done)(void *arg), void *arg)
+{
+	SSD1322_bus_job_t *job = add_job(bus, device, done, arg);
+	if (job == NULL)
+		return 0;
+
+	const uint8_t window[10] =
+	{
+		SET_COLUMN_ADDR, 2, 28 + start_column, 28 + end_column,
+		SET_ROW_ADDR, 2, start_row, end_row,
+		ENABLE_RAM_WRITE, 0
+	};
+	memcpy(job->window, window, sizeof(window));
+	job->commands_size = sizeof(window);
+	job->data = data;
+	job->data_size = data_size;
+	bus->count++;
+	return 1;
+}
+
+//====================== pick next job ========================//
+/**
+ *  @brief Finds next job to serve, going round robin over queue.
+ *
+ *  Only the oldest job of each display can be picked, so jobs of one display keep their order.
+ */
+static uint8_t pick_job(const SSD1322_bus_t *bus)
+{
+	for (uint8_t k = 0; k < bus->count; k++)
+	{
+		uint8_t i = (bus->next + k) % bus->count;
+		uint8_t oldest = 1;
+		for (uint8_t j = 0; j < i; j++)
+		{
+			if (bus->jobs[j].device == bus->jobs[i].device)
+			{
+				oldest = 0;
+				break;
+			}
+		}
+		if (oldest)
+			return i;
+	}
+	return 0;
+}
+
+//====================== finish job ========================//
+/**
+ *  @brief Removes job from queue if everything was sent and calls its done callback.
+ */
+static void finish_job(SSD1322_bus_t *bus, uint8_t i)
+{
+	SSD1322_bus_job_t *job = &bus->jobs[i];
+	if (job->commands_pos < job->commands_size || job->data_pos < job->data_size)
+		return;
+
+	void (*done)(void *arg) = job->done;
+	void *arg = job->arg;
+
+	memmove(&bus->jobs[i], &bus->jobs[i + 1], (bus->count - i - 1) * sizeof(SSD1322_bus_job_t));
+	bus->count--;
+	if (bus->next > i)
+		bus->next--;
+
+	if (done)
+		done(arg);
+}
+
+//====================== run queue ========================//
+/**
+ *  @brief Sends queued jobs until queue is empty or non blocking transfer is started.
+ */
+static void run(SSD1322_bus_t *bus)
+{
+	while (!bus->busy && bus->count)
+	{
+		uint8_t i = pick_job(bus);
+		SSD1322_bus_job_t *job = &bus->jobs[i];
+		SSD1322_device_t *device = job->device;
+		bus->next = i + 1;
+
+		if (job->commands_pos + 1 < job->commands_size)
+		{
+			//commands are short, so they are always sent in blocking mode
+			const uint8_t *command = job_commands(job) + job->commands_pos;
+			uint32_t length = 2 + command[1];
+			SSD1322_API_command_sequence(device, command, length);
+			job->commands_pos += length;
+		}
+		else
+		{
+			job->commands_pos = job->commands_size;
+			if (job->data_pos < job->data_size)
+			{
+				const uint8_t *chunk = job->data + job->data_pos;
+				uint32_t length = job->data_size - job->data_pos;
+				if (length > bus->chunk_size)
+					length = bus->chunk_size;
+				job->data_pos += length;
+
+				device->hw->drive_CS(device->context, 0);
+				device->hw->drive_DC(device->context, 1);
+				if (device->hw->SPI_start_array && device->hw->SPI_start_array(device->context, chunk, length))
+				{
+					bus->active = i;
+					bus->busy = 1;
+					return;
+				}
+				device->hw->SPI_send_array(device->context, chunk, length);
+				device->hw->drive_CS(device->context, 1);
+			}
+		}
+		finish_job(bus, i);
+	}
+}
+
+//====================== poll bus ========================//
+/**
+ *  @brief Starts sending queued jobs if bus is free.
+ *
+ *  With blocking SPI this sends the whole queue. With non blocking SPI it sends commands
+ *  until first chunk of pixel data is started, next ones are started by SSD1322_bus_transfer_done().
+ *
+ *  @param[in] bus
+ *             bus shared by displays
+ */
+void SSD1322_bus_poll(SSD1322_bus_t *bus)
+{
+	if (!bus->busy)
+		run(bus);
+}
+
+//====================== transfer done ========================//
+/**
+ *  @brief Finishes non blocking transfer and starts the next one.
+ *
+ *  Has to be called from SPI (or DMA) transfer complete interrupt of the port when
+ *  SPI_start_array() transfer has ended.
+ *
+ *  @param[in] bus
+ *             bus shared by displays
+ */
+void SSD1322_bus_transfer_done(SSD1322_bus_t *bus)
+{
+	if (!bus->busy)
+		return;
+
+	SSD1322_device_t *device = bus->jobs[bus->active].device;
+	device->hw->drive_CS(device->context, 1);
+	bus->busy = 0;
+	finish_job(bus, bus->active);
+	run(bus);
+}
+
+//====================== bus idle ========================//
+/**
+ *  @brief Checks if all queued jobs were sent.
+ *
+ *  @return 1 if queue is empty and no transfer is in progress
+ */
+uint8_t SSD1322_bus_idle(const SSD1322_bus_t *bus)
+{
+	return bus->count == 0 && !bus->busy;
+}
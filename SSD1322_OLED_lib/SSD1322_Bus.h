@@ -0,0 +1,76 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Bus.h
+ *
+ * \brief Transfer scheduler for several SSD1322 displays sharing one SPI bus.
+ *
+ * Transfers for all displays are queued as jobs. Scheduler serves displays in turns,
+ * sending one command or one chunk of pixel data at a time, so commands for one display
+ * are not stuck behind a whole frame sent to another one.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_BUS_H
+#define SSD1322_BUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_HW_Driver.h"
+
+/*============ defines ============*/
+
+#define BUS_DEFAULT_CHUNK_SIZE  512    //bytes of pixel data sent to one display before switching to next one
+
+/*============ bus structures ============*/
+
+// Queued transfer for one display
+typedef struct {
+  SSD1322_device_t *device;       ///< Display that job is sent to
+  const uint8_t *commands;        ///< Commands in SSD1322_API_command_sequence() format, sent first
+  uint32_t commands_size;         ///< Size of commands array in bytes
+  const uint8_t *data;            ///< Pixel data sent after commands or NULL
+  uint32_t data_size;             ///< Amount of pixel data bytes
+  void (*done)(void *arg);        ///< Called when whole job was sent or NULL
+  void *arg;                      ///< Passed to done callback
+  uint32_t commands_pos;          ///< Position of next command to send
+  uint32_t data_pos;              ///< Position of next pixel data chunk to send
+  uint8_t window[10];             ///< Commands of window set by SSD1322_bus_queue_window()
+} SSD1322_bus_job_t;
+
+// Jobs waiting for shared SPI bus
+typedef struct {
+  SSD1322_bus_job_t *jobs;        ///< Array for queued jobs
+  uint8_t size;                   ///< Size of jobs array
+  uint8_t count;                  ///< Amount of queued jobs
+  uint8_t next;                   ///< Queue position where search for next job starts
+  uint8_t active;                 ///< Job with non blocking transfer in progress
+  volatile uint8_t busy;          ///< 1 while non blocking transfer is in progress
+  uint32_t chunk_size;            ///< Max amount of pixel data bytes sent at once
+} SSD1322_bus_t;
+
+/*============ functions ============*/
+
+void SSD1322_bus_init(SSD1322_bus_t *bus, SSD1322_bus_job_t *jobs, uint8_t size, uint32_t chunk_size);
+uint8_t SSD1322_bus_queue_commands(SSD1322_bus_t *bus, SSD1322_device_t *device, const uint8_t *commands, uint32_t commands_size,
+		void (*done)(void *arg), void *arg);
+uint8_t SSD1322_bus_queue_window(SSD1322_bus_t *bus, SSD1322_device_t *device, uint8_t start_column, uint8_t end_column,
+		uint8_t start_row, uint8_t end_row, const uint8_t *data, uint32_t data_size, void (*done)(void *arg), void *arg);
+void SSD1322_bus_poll(SSD1322_bus_t *bus);
+void SSD1322_bus_transfer_done(SSD1322_bus_t *bus);
+uint8_t SSD1322_bus_idle(const SSD1322_bus_t *bus);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_BUS_H */
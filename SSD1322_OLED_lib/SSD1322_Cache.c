@@ -0,0 +1,212 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Cache.c
+ *
+ * \brief Drawing of bitmaps and fonts stored in external memory through a small RAM cache.
+ *
+ * Cache is a set of equal slots, every slot holds one block read from external memory
+ * together with its address. Slots are searched linearly, which is fast for the few dozens
+ * of slots that fit in MCU RAM. Every access stamps the slot with incremented clock, so on
+ * a miss the slot with the oldest stamp is the least recently used one.
+ *
+ * Bitmaps are split into bands of whole rows that fit in one slot, fonts are loaded one glyph
+ * at a time through GFXfont bitmap loader.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Cache.h"
+
+#include <stddef.h>
+
+//====================== init cache ========================//
+/**
+ *  @brief Prepares empty cache.
+ *
+ *  @param[in] cache
+ *             cache to prepare
+ *  @param[in] read
+ *             function reading blocks of external memory, returns 1 on success and 0 on error
+ *  @param[in] context
+ *             passed to read function
+ *  @param[in] memory
+ *             array of CACHE_MEMORY_SIZE(slot_size, slot_count) bytes
+ *  @param[in] slots
+ *             array of slot_count elements
+ *  @param[in] slot_size
+ *             size of single slot in bytes, biggest glyph or bitmap row has to fit in it
+ *  @param[in] slot_count
+ *             amount of slots
+ */
+void cache_init(GFXcache *cache, uint8_t (*read)(void *context, uint32_t address, uint8_t *buffer, uint32_t size), void *context,
+		uint8_t *memory, GFXcache_slot *slots, uint16_t slot_size, uint16_t slot_count)
+{
+	cache->read = read;
+	cache->context = context;
+	cache->memory = memory;
+	cache->slots = slots;
+	cache->slot_size = slot_size;
+	cache->slot_count = slot_count;
+	cache_flush(cache);
+}
+
+//====================== flush cache ========================//
+/**
+ *  @brief Forgets all cached blocks, for example after external memory was written.
+ *
+ *  @param[in] cache
+ *             cache to flush
+ */
+void cache_flush(GFXcache *cache)
+{
+	for (uint16_t i = 0; i < cache->slot_count; i++)
+	{
+		cache->slots[i].last_use = 0;
+		cache->slots[i].size = 0;
+	}
+	cache->clock = 0;
+	cache->hits = 0;
+	cache->misses = 0;
+}
+
+//====================== get block ========================//
+/**
+ *  @brief Returns block of external memory, reading it only if it is not cached.
+ *
+ *  Returned pointer is valid until next call of cache_get() or cache_flush().
+ *
+ *  @param[in] cache
+ *             cache to use
+ *  @param[in] address
+ *             address of block in external memory
+ *  @param[in] size
+ *             size of block in bytes, not bigger than slot size
+ *
+ *  @return pointer to block data or NULL if block is too big or could not be read
+ */
+const uint8_t *cache_get(GFXcache *cache, uint32_t address, uint16_t size)
+{
+	GFXcache_slot *victim = NULL;
+
+	if (size > cache->slot_size || cache->slot_count == 0)
+		return NULL;
+
+	//clock is about to wrap - start over instead of mixing old and new stamps
+	if (cache->clock == UINT32_MAX)
+		cache_flush(cache);
+	cache->clock++;
+
+	for (uint16_t i = 0; i < cache->slot_count; i++)
+	{
+		GFXcache_slot *slot = &cache->slots[i];
+		if (slot->last_use != 0 && slot->address == address && slot->size >= size)
+		{
+			slot->last_use = cache->clock;
+			cache->hits++;
+			return cache->memory + (uint32_t)i * cache->slot_size;
+		}
+		if (victim == NULL || slot->last_use < victim->last_use)
+			victim = slot;
+	}
+
+	uint8_t *data = cache->memory + (uint32_t)(victim - cache->slots) * cache->slot_size;
+	cache->misses++;
+	if (!cache->read(cache->context, address, data, size))
+	{
+		victim->last_use = 0;
+		return NULL;
+	}
+	victim->address = address;
+	victim->size = size;
+	victim->last_use = cache->clock;
+	return data;
+}
+
+//====================== draw cached 4-bit bitmap ========================//
+/**
+ *  @brief Draws 4 bits per pixel bitmap stored in external memory
+ *
+ *  Bitmap format is the same as in draw_bitmap_4bpp(). It is drawn in bands of rows that fit
+ *  in one cache slot, so bitmap can be bigger than the whole cache. Odd width bitmaps are split
+ *  after even amount of rows, so every band starts at a whole byte.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] cache
+ *             cache to read bitmap through
+ *  @param[in] address
+ *             address of bitmap in external memory
+ *  @param[in] x0
+ *             x position of top left bitmap corner
+ *  @param[in] y0
+ *             y position of top left bitmap corner
+ *  @param[in] x_size
+ *             width of bitmap in pixels
+ *  @param[in] y_size
+ *             height of bitmap in pixels
+ *
+ *  @return 1 if bitmap was drawn, 0 if rows do not fit in slot or read failed
+ */
+uint8_t draw_cached_bitmap_4bpp(GFXcanvas *canvas, GFXcache *cache, uint32_t address, uint16_t x0, uint16_t y0, uint16_t x_size,
+		uint16_t y_size)
+{
+	uint32_t fitting_rows = (uint32_t)cache->slot_size * 2 / (x_size ? x_size : 1);
+	uint16_t band_rows = fitting_rows < y_size ? fitting_rows : y_size;
+
+	if (x_size % 2 == 1 && band_rows < y_size)
+		band_rows &= ~1;
+	if (band_rows == 0)
+		return y_size == 0;
+
+	for (uint16_t row = 0; row < y_size; row += band_rows)
+	{
+		uint16_t rows = y_size - row < band_rows ? y_size - row : band_rows;
+		const uint8_t *band = cache_get(cache, address + (uint32_t)row * x_size / 2, ((uint32_t)rows * x_size + 1) / 2);
+		if (band == NULL)
+			return 0;
+		draw_bitmap_4bpp(canvas, band, x0, y0 + row, x_size, rows);
+	}
+	return 1;
+}
+
+//====================== load glyph bitmap ========================//
+/**
+ *  @brief Bitmap loader of external fonts, see cache_attach_font().
+ */
+static const uint8_t *load_glyph(void *loader, const GFXglyph *glyph)
+{
+	GFXcache_font *external = loader;
+
+	return cache_get(external->cache, external->bitmap_address + glyph->bitmapOffset, ((uint16_t)glyph->width * glyph->height + 7) / 8);
+}
+
+//====================== attach font to cache ========================//
+/**
+ *  @brief Makes font read glyph bitmaps from external memory
+ *
+ *  Glyph table (and codepoints of sparse font) stay in GFXfont, only bitmap array is external.
+ *  After this call font can be selected and used with all text functions.
+ *
+ *  @param[in] font
+ *             font to attach, its bitmap pointer is not used anymore
+ *  @param[in] external
+ *             loader state, has to stay valid as long as font is used
+ *  @param[in] cache
+ *             cache to read glyphs through
+ *  @param[in] bitmap_address
+ *             address of concatenated glyph bitmaps in external memory
+ */
+void cache_attach_font(GFXfont *font, GFXcache_font *external, GFXcache *cache, uint32_t bitmap_address)
+{
+	external->cache = cache;
+	external->bitmap_address = bitmap_address;
+	font->load_bitmap = load_glyph;
+	font->loader = external;
+}
@@ -0,0 +1,78 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Cache.h
+ *
+ * \brief Drawing of bitmaps and fonts stored in external memory through a small RAM cache.
+ *
+ * Data is read with a block read function, so it can come from SPI NOR flash, SD card or
+ * a file. Recently used bitmap tiles and glyphs are kept in fixed amount of RAM and the least
+ * recently used one is replaced on a miss.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_CACHE_H
+#define SSD1322_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+
+/*============ defines ============*/
+
+// Size of memory array in bytes for given amount of slots
+#define CACHE_MEMORY_SIZE(slot_size, slot_count)  ((uint32_t)(slot_size) * (slot_count))
+
+/*============ cache structures ============*/
+
+// Single cached block
+typedef struct {
+  uint32_t address;    ///< Address of block in external memory
+  uint32_t last_use;   ///< Value of cache clock at last access, 0 if slot is empty
+  uint16_t size;       ///< Amount of valid bytes
+} GFXcache_slot;
+
+// Cache of external memory blocks
+typedef struct {
+  uint8_t (*read)(void *context, uint32_t address, uint8_t *buffer, uint32_t size);  ///< Reads size bytes from address, returns 1 on success
+  void *context;           ///< Passed to read function
+  uint8_t *memory;         ///< Data of all slots, slot_size bytes each
+  GFXcache_slot *slots;    ///< Description of every slot
+  uint16_t slot_size;      ///< Biggest block that can be cached
+  uint16_t slot_count;     ///< Amount of slots
+  uint32_t clock;          ///< Incremented on every access
+  uint32_t hits;           ///< Accesses served from RAM
+  uint32_t misses;         ///< Accesses that needed external read
+} GFXcache;
+
+// Font with glyph bitmaps in external memory, glyph table stays in GFXfont
+typedef struct {
+  GFXcache *cache;           ///< Cache used for glyph bitmaps
+  uint32_t bitmap_address;   ///< Address of concatenated glyph bitmaps
+} GFXcache_font;
+
+/*============ functions ============*/
+
+void cache_init(GFXcache *cache, uint8_t (*read)(void *context, uint32_t address, uint8_t *buffer, uint32_t size), void *context,
+		uint8_t *memory, GFXcache_slot *slots, uint16_t slot_size, uint16_t slot_count);
+void cache_flush(GFXcache *cache);
+const uint8_t *cache_get(GFXcache *cache, uint32_t address, uint16_t size);
+
+uint8_t draw_cached_bitmap_4bpp(GFXcanvas *canvas, GFXcache *cache, uint32_t address, uint16_t x0, uint16_t y0, uint16_t x_size,
+		uint16_t y_size);
+void cache_attach_font(GFXfont *font, GFXcache_font *external, GFXcache *cache, uint32_t bitmap_address);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_CACHE_H */
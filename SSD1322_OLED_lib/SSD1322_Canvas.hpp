@@ -0,0 +1,300 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Canvas.hpp
+ *
+ * \brief Header-only C++ canvas with frame buffer geometry known at compile time.
+ *
+ * Canvas<W, H> wraps GFXcanvas of the C library. Width, height and stride are template
+ * parameters, so pixel addressing in inline functions compiles to shifts and masks and
+ * buffer size is checked by compiler. Pixels, fills, horizontal lines, filled rectangles and
+ * 4-bit bitmaps of unrotated canvas are written inline with compile-time stride. Everything
+ * else, and every drawing on rotated canvas, is forwarded to C functions, which use stride
+ * stored in GFXcanvas.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_CANVAS_HPP
+#define SSD1322_CANVAS_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+
+namespace SSD1322
+{
+
+template<uint16_t W, uint16_t H, uint16_t Stride = W / 2>
+class Canvas
+{
+	static_assert(W > 0 && H > 0, "canvas has to have at least one pixel");
+	static_assert(W % 2 == 0, "canvas width has to be even, two pixels are stored in a byte");
+	static_assert(Stride >= W / 2, "stride has to fit a whole row of pixels");
+
+public:
+	static constexpr uint16_t width = W;
+	static constexpr uint16_t height = H;
+	static constexpr uint16_t stride = Stride;
+	static constexpr uint32_t buffer_size = (uint32_t)Stride * H;
+
+	//====================== constructor ========================//
+	/**
+	 *  @brief Creates canvas over a frame buffer array. Array size is checked at compile time.
+	 */
+	template<size_t N>
+	explicit Canvas(uint8_t (&buffer)[N])
+	{
+		static_assert(N >= buffer_size, "frame buffer is too small for canvas geometry");
+		canvas_init(&canvas_, buffer, W, H);
+		canvas_.stride = Stride;
+	}
+
+	//====================== access to C canvas ========================//
+	/**
+	 *  @brief Gives GFXcanvas for functions of C modules (animations, sprites, layers...).
+	 */
+	GFXcanvas *c()
+	{
+		return &canvas_;
+	}
+
+	uint8_t *buffer()
+	{
+		return canvas_.buffer;
+	}
+
+	//====================== state ========================//
+	void set_clip(const GFXrect &clip)
+	{
+		canvas_set_clip(&canvas_, &clip);
+	}
+
+	void reset_clip()
+	{
+		canvas_reset_clip(&canvas_);
+	}
+
+	void rotation(uint8_t rotation)
+	{
+		set_rotation(&canvas_, rotation);
+	}
+
+	void font(const GFXfont *font)
+	{
+		select_font(&canvas_, font);
+	}
+
+	void device(SSD1322_device_t *device)
+	{
+		canvas_.device = device;
+	}
+
+	//====================== inline pixel access ========================//
+	/**
+	 *  @brief Draws pixel. Without rotation address is computed inline from compile-time stride.
+	 */
+	void pixel(uint16_t x, uint16_t y, uint8_t brightness)
+	{
+		if (canvas_.rotation != GFX_ROTATION_0)
+		{
+			draw_pixel(&canvas_, x, y, brightness);
+			return;
+		}
+		if (x < canvas_.clip.x0 || x > canvas_.clip.x1 || y < canvas_.clip.y0 || y > canvas_.clip.y1)
+			return;
+
+		uint8_t *byte = canvas_.buffer + (uint32_t)y * Stride + (x >> 1);
+		uint8_t shift = (~x & 1) << 2;
+		*byte = (*byte & ~(0x0F << shift)) | ((brightness & 0x0F) << shift);
+	}
+
+	/**
+	 *  @brief Reads pixel, 0 outside of canvas. Coordinates are rotated the same way as in pixel().
+	 */
+	uint8_t get_pixel(uint16_t x, uint16_t y) const
+	{
+		if (canvas_.rotation != GFX_ROTATION_0)
+			return ::get_pixel(&canvas_, x, y);
+		if (x >= W || y >= H)
+			return 0;
+		return (canvas_.buffer[(uint32_t)y * Stride + (x >> 1)] >> ((~x & 1) << 2)) & 0x0F;
+	}
+
+	/**
+	 *  @brief Fills canvas. Canvas without clipping and padding is filled with one memset.
+	 */
+	void fill(uint8_t brightness)
+	{
+		if (Stride == W / 2 && canvas_.clip.x0 == 0 && canvas_.clip.y0 == 0 && canvas_.clip.x1 == W - 1 && canvas_.clip.y1 == H - 1)
+			memset(canvas_.buffer, (brightness << 4) | (brightness & 0x0F), buffer_size);
+		else
+			fill_buffer(&canvas_, brightness);
+	}
+
+	/**
+	 *  @brief Draws horizontal line. Without rotation whole bytes are filled inline.
+	 */
+	void hline(uint16_t y, uint16_t x0, uint16_t x1, uint8_t brightness)
+	{
+		if (canvas_.rotation != GFX_ROTATION_0)
+		{
+			draw_hline(&canvas_, y, x0, x1, brightness);
+			return;
+		}
+		if (y < canvas_.clip.y0 || y > canvas_.clip.y1 || !clip_span(canvas_.clip.x0, canvas_.clip.x1, x0, x1))
+			return;
+		fill_row(y, x0, x1, brightness & 0x0F);
+	}
+
+	/**
+	 *  @brief Draws filled rectangle. Without rotation rows are filled inline.
+	 */
+	void rect_filled(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness)
+	{
+		if (canvas_.rotation != GFX_ROTATION_0)
+		{
+			draw_rect_filled(&canvas_, x0, y0, x1, y1, brightness);
+			return;
+		}
+		if (!clip_span(canvas_.clip.x0, canvas_.clip.x1, x0, x1) || !clip_span(canvas_.clip.y0, canvas_.clip.y1, y0, y1))
+			return;
+		for (uint32_t y = y0; y <= y1; y++)
+		{
+			fill_row(y, x0, x1, brightness & 0x0F);
+		}
+	}
+
+	/**
+	 *  @brief Draws 4-bit bitmap. Unrotated bitmap with even x0 and width that fits horizontally
+	 *         in clipping rectangle is copied row by row, other cases are forwarded.
+	 */
+	void bitmap_4bpp(const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size)
+	{
+		if (canvas_.rotation != GFX_ROTATION_0 || x0 % 2 == 1 || x_size % 2 == 1 || x_size == 0 || x0 < canvas_.clip.x0
+				|| (uint32_t)x0 + x_size - 1 > canvas_.clip.x1)
+		{
+			draw_bitmap_4bpp(&canvas_, bitmap, x0, y0, x_size, y_size);
+			return;
+		}
+		for (uint32_t i = 0; i < y_size; i++)
+		{
+			uint32_t y = y0 + i;
+			if (y < canvas_.clip.y0)
+				continue;
+			if (y > canvas_.clip.y1)
+				break;
+			memcpy(canvas_.buffer + y * Stride + x0 / 2, bitmap + i * (x_size / 2), x_size / 2);
+		}
+	}
+
+	//====================== forwarded drawing functions ========================//
+
+	void vline(uint16_t x, uint16_t y0, uint16_t y1, uint8_t brightness)
+	{
+		draw_vline(&canvas_, x, y0, y1, brightness);
+	}
+
+	void line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness)
+	{
+		draw_line(&canvas_, x0, y0, x1, y1, brightness);
+	}
+
+	void AA_line(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness)
+	{
+		draw_AA_line(&canvas_, x0, y0, x1, y1, brightness);
+	}
+
+	void rect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness)
+	{
+		draw_rect(&canvas_, x0, y0, x1, y1, brightness);
+	}
+
+	void circle(uint16_t x0, uint16_t y0, uint16_t r, uint8_t brightness)
+	{
+		draw_circle(&canvas_, x0, y0, r, brightness);
+	}
+
+	void bitmap_8bpp(const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size)
+	{
+		draw_bitmap_8bpp(&canvas_, bitmap, x0, y0, x_size, y_size);
+	}
+
+	void text(const char *text, uint16_t x, uint16_t y, uint8_t brightness)
+	{
+		draw_text(&canvas_, text, x, y, brightness);
+	}
+
+	//====================== sending to OLED ========================//
+	void send(uint16_t start_x = 0, uint16_t start_y = 0)
+	{
+		send_buffer_to_OLED(&canvas_, start_x, start_y);
+	}
+
+	void send_rect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+	{
+		send_rect_to_OLED(&canvas_, x0, y0, x1, y1);
+	}
+
+private:
+	//====================== inline helpers ========================//
+	/**
+	 *  @brief Orders span ends and cuts them to lo-hi range.
+	 *
+	 *  @return false if nothing of the span is left
+	 */
+	static bool clip_span(uint16_t lo, uint16_t hi, uint16_t &a0, uint16_t &a1)
+	{
+		if (a0 > a1)
+		{
+			uint16_t tmp = a0;
+			a0 = a1;
+			a1 = tmp;
+		}
+		if (a1 < lo || a0 > hi)
+			return false;
+		if (a0 < lo)
+			a0 = lo;
+		if (a1 > hi)
+			a1 = hi;
+		return true;
+	}
+
+	/**
+	 *  @brief Fills frame buffer row from x0 to x1, both already clipped. Odd ends are written by nibble.
+	 */
+	void fill_row(uint16_t y, uint16_t x0, uint16_t x1, uint8_t brightness)
+	{
+		uint8_t *row = canvas_.buffer + (uint32_t)y * Stride;
+
+		if (x0 & 1)
+		{
+			row[x0 >> 1] = (row[x0 >> 1] & 0xF0) | brightness;
+			x0++;
+		}
+		if (!(x1 & 1) && x1 >= x0)
+		{
+			row[x1 >> 1] = (row[x1 >> 1] & 0x0F) | (brightness << 4);
+			if (x1 == 0)
+				return;
+			x1--;
+		}
+		if (x1 > x0)
+			memset(row + (x0 >> 1), (brightness << 4) | brightness, (x1 - x0 + 1) / 2);
+	}
+
+	GFXcanvas canvas_;
+};
+
+// Frame buffer matching the whole 256x64 panel
+typedef Canvas<OLED_WIDTH, OLED_HEIGHT> PanelCanvas;
+
+}
+
+#endif /* SSD1322_CANVAS_HPP */
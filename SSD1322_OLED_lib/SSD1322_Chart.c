@@ -0,0 +1,158 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Chart.c
+ *
+ * \brief Scrolling strip chart for time series (oscilloscope like plot).
+ *
+ * Plot is moved left with scroll_rect(), which shifts packed rows in place. Each new sample
+ * is a vertical span from the previous sample row to its own row, so steep edges stay connected.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Chart.h"
+
+#include <string.h>
+
+//====================== init chart ========================//
+/**
+ *  @brief Prepares empty chart. Plot area is cleared on first chart_push().
+ *
+ *  Chart works in frame buffer coordinates, rotation and clipping of canvas are not used.
+ *
+ *  @param[in] chart
+ *             chart to prepare
+ *  @param[in] canvas
+ *             canvas that chart is drawn on
+ *  @param[in] area
+ *             plot area, has to lie inside canvas
+ *  @param[in] min
+ *             sample value shown at the bottom edge
+ *  @param[in] max
+ *             sample value shown at the top edge, has to be different from min
+ */
+void chart_init(GFXchart *chart, GFXcanvas *canvas, const GFXrect *area, int32_t min, int32_t max)
+{
+	chart->canvas = canvas;
+	chart->area = *area;
+	chart->min = min;
+	chart->max = max;
+	chart->brightness = 15;
+	chart->background = 0;
+	chart->decay = 0;
+	chart->drawn = 0;
+	chart->last_y = area->y1;
+}
+
+//====================== set pixel ========================//
+static inline void set_pixel(uint8_t *row, uint16_t x, uint8_t brightness)
+{
+	if (x & 1)
+		row[x / 2] = (row[x / 2] & 0xF0) | brightness;
+	else
+		row[x / 2] = (row[x / 2] & 0x0F) | (brightness << 4);
+}
+
+//====================== dim row ========================//
+/**
+ *  @brief Lowers brightness of pixels x0..x1 of a row by decay, not below background.
+ */
+static void decay_row(uint8_t *row, uint16_t x0, uint16_t x1, uint8_t decay, uint8_t background)
+{
+	for (uint16_t x = x0; x <= x1; x++)
+	{
+		uint8_t value = (x & 1) ? row[x / 2] & 0x0F : row[x / 2] >> 4;
+		if (value <= background)
+			continue;
+		value = value - background > decay ? value - decay : background;
+		set_pixel(row, x, value);
+	}
+}
+
+//====================== sample row ========================//
+static uint16_t sample_row(const GFXchart *chart, int32_t sample)
+{
+	int32_t height = chart->area.y1 - chart->area.y0;
+	int32_t low = chart->min < chart->max ? chart->min : chart->max;
+	int32_t high = chart->min < chart->max ? chart->max : chart->min;
+
+	if (sample < low)
+		sample = low;
+	if (sample > high)
+		sample = high;
+	return chart->area.y1 - (int64_t)(sample - chart->min) * height / (chart->max - chart->min);
+}
+
+//====================== push samples ========================//
+/**
+ *  @brief Scrolls plot left by amount of new samples and draws them in the freed columns.
+ *
+ *  Whole plot area is sent to OLED (or added to damage list), because all of it has moved.
+ *
+ *  @param[in] chart
+ *             chart to update
+ *  @param[in,out] damage
+ *             list that plot area is added to, NULL to send it to OLED right away
+ *  @param[in] samples
+ *             new samples, the oldest first
+ *  @param[in] count
+ *             amount of new samples
+ */
+void chart_push(GFXchart *chart, GFXdamage *damage, const int32_t *samples, uint16_t count)
+{
+	GFXcanvas *canvas = chart->canvas;
+	GFXrect *area = &chart->area;
+	uint16_t width = area->x1 - area->x0 + 1;
+	GFXrect clip = canvas->clip;
+	uint8_t rotation = canvas->rotation;
+
+	//chart is placed in frame buffer coordinates
+	canvas->rotation = GFX_ROTATION_0;
+	canvas_reset_clip(canvas);
+
+	//only the newest samples that fit are drawn
+	if (count > width)
+	{
+		samples += count - width;
+		count = width;
+	}
+
+	//first drawn sample starts the trace, so it is not connected to a dropped one
+	if (!chart->drawn)
+	{
+		draw_rect_filled(canvas, area->x0, area->y0, area->x1, area->y1, chart->background);
+		chart->last_y = count ? sample_row(chart, samples[0]) : area->y1;
+		chart->drawn = 1;
+	}
+
+	scroll_rect(canvas, area, -count, 0, chart->background);
+	if (chart->decay && count < width)
+	{
+		for (uint16_t y = area->y0; y <= area->y1; y++)
+		{
+			decay_row(canvas->buffer + (uint32_t)y * canvas->stride, area->x0, area->x1 - count, chart->decay, chart->background);
+		}
+	}
+
+	for (uint16_t i = 0; i < count; i++)
+	{
+		uint16_t y = sample_row(chart, samples[i]);
+		draw_vline(canvas, area->x1 - count + 1 + i, chart->last_y, y, chart->brightness);
+		chart->last_y = y;
+	}
+
+	canvas->rotation = rotation;
+	canvas->clip = clip;
+
+	if (damage != NULL)
+		damage_add(damage, area);
+	else
+		send_rect_to_OLED(canvas, area->x0, area->y0, area->x1, area->y1);
+}
@@ -0,0 +1,53 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Chart.h
+ *
+ * \brief Scrolling strip chart for time series (oscilloscope like plot).
+ *
+ * New samples are appended on the right. Existing pixels are shifted left in place,
+ * so only the new sample columns are drawn. Optional decay dims older parts of the trace
+ * like phosphor of an analog oscilloscope.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_CHART_H
+#define SSD1322_CHART_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+
+/*============ chart structure ============*/
+
+typedef struct {
+  GFXcanvas *canvas;     ///< Canvas that chart is drawn on
+  GFXrect area;          ///< Plot area in frame buffer coordinates
+  int32_t min;           ///< Sample value at the bottom edge
+  int32_t max;           ///< Sample value at the top edge
+  uint8_t brightness;    ///< Brightness of new samples
+  uint8_t background;    ///< Brightness of empty plot
+  uint8_t decay;         ///< Brightness subtracted from older pixels at every push, 0 for no decay
+  uint8_t drawn;         ///< 1 if plot area was cleared, clear to start again from empty plot
+  uint16_t last_y;       ///< Row of the last sample, new sample is connected to it
+} GFXchart;
+
+/*============ functions ============*/
+
+void chart_init(GFXchart *chart, GFXcanvas *canvas, const GFXrect *area, int32_t min, int32_t max);
+void chart_push(GFXchart *chart, GFXdamage *damage, const int32_t *samples, uint16_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_CHART_H */
@@ -0,0 +1,510 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Curves.c
+ *
+ * \brief Arcs, pie segments and Bezier curves drawn with integer arithmetic.
+ *
+ * Arcs use midpoint circle algorithm and pixels outside of the angle range are skipped.
+ * Range is checked with cross products against start and end directions taken from
+ * a sine table, so no trigonometric function is called per pixel. Antialiased arc computes
+ * exact circle position with integer square root and splits brightness between two pixels
+ * (Xiaolin Wu's method). Bezier curves are evaluated with integer forward differencing
+ * and joined with straight segments, antialiased ones with Wu segments that start and end
+ * at 1/16 pixel positions. Antialiased pixels are blended with what is already drawn by
+ * keeping the brighter value.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Curves.h"
+
+#include <stdlib.h>
+
+// sin() of 0-90 degrees scaled by 16384
+static const int16_t sine_table[91] = {
+		0, 286, 572, 857, 1143, 1428, 1713, 1997, 2280, 2563,
+		2845, 3126, 3406, 3686, 3964, 4240, 4516, 4790, 5063, 5334,
+		5604, 5872, 6138, 6402, 6664, 6924, 7182, 7438, 7692, 7943,
+		8192, 8438, 8682, 8923, 9162, 9397, 9630, 9860, 10087, 10311,
+		10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+		12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+		14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+		15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+		16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+		16384
+};
+
+// Angle range of an arc, directions have y axis pointing up
+typedef struct {
+	int32_t start_x;
+	int32_t start_y;
+	int32_t end_x;
+	int32_t end_y;
+	int16_t sweep;      ///< Angle between start and end, 0-359
+	uint8_t full;       ///< 1 for whole circle
+} arc_range;
+
+//====================== integer square root ========================//
+/**
+ *  @brief Computes floor of square root without floating point.
+ *
+ *  @param[in] value
+ *             number to take root of
+ *
+ *  @return largest integer whose square is not bigger than value
+ */
+uint32_t curves_isqrt(uint32_t value)
+{
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;
+
+	while (bit > value)
+		bit >>= 2;
+	while (bit)
+	{
+		if (value >= root + bit)
+		{
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+		{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return root;
+}
+
+//====================== sine ========================//
+/**
+ *  @brief Returns sine of angle in degrees scaled by 16384, from lookup table.
+ */
+int16_t curves_sin_deg(int16_t angle)
+{
+	angle %= 360;
+	if (angle < 0)
+		angle += 360;
+
+	if (angle <= 90)
+		return sine_table[angle];
+	if (angle <= 180)
+		return sine_table[180 - angle];
+	if (angle <= 270)
+		return -sine_table[angle - 180];
+	return -sine_table[360 - angle];
+}
+
+//====================== cosine ========================//
+/**
+ *  @brief Returns cosine of angle in degrees scaled by 16384, from lookup table.
+ */
+int16_t curves_cos_deg(int16_t angle)
+{
+	return curves_sin_deg(angle + 90);
+}
+
+//====================== prepare angle range ========================//
+static void arc_range_init(arc_range *range, int16_t start, int16_t end)
+{
+	int32_t sweep = (int32_t)end - start;
+
+	range->full = sweep >= 360;
+	sweep %= 360;
+	if (sweep < 0)
+		sweep += 360;
+	range->sweep = sweep;
+	range->start_x = curves_cos_deg(start);
+	range->start_y = curves_sin_deg(start);
+	range->end_x = curves_cos_deg(end);
+	range->end_y = curves_sin_deg(end);
+}
+
+//====================== check angle range ========================//
+/**
+ *  @brief Checks if direction from circle center to pixel (dx, dy) lies inside angle range.
+ */
+static uint8_t arc_range_contains(const arc_range *range, int32_t dx, int32_t dy)
+{
+	int32_t qx = dx, qy = -dy;    //screen y grows down
+
+	if (range->full)
+		return 1;
+
+	int32_t after_start = range->start_x * qy - range->start_y * qx;
+	int32_t before_end = qx * range->end_y - qy * range->end_x;
+
+	if (range->sweep <= 180)
+	{
+		if (range->sweep == 0 && range->start_x * qx + range->start_y * qy < 0)
+			return 0;
+		return after_start >= 0 && before_end >= 0;
+	}
+	//more than half circle - pixel is inside unless it is strictly in the remaining part
+	return !(after_start < 0 && before_end < 0);
+}
+
+//====================== plot pixel ========================//
+static void plot(GFXcanvas *canvas, int32_t x, int32_t y, uint8_t brightness)
+{
+	if (x < 0 || y < 0 || x > 0xFFFF || y > 0xFFFF)
+		return;
+	draw_pixel(canvas, x, y, brightness);
+}
+
+//====================== blend antialiased pixel ========================//
+/**
+ *  @brief Draws pixel with part of brightness, only if it is brighter than existing one.
+ *
+ *  @param[in] coverage
+ *             part of pixel covered by shape, 0-16
+ */
+static void plot_AA(GFXcanvas *canvas, int32_t x, int32_t y, uint8_t coverage, uint8_t brightness)
+{
+	if (coverage == 0 || x < 0 || y < 0 || x > 0xFFFF || y > 0xFFFF)
+		return;
+
+	uint8_t value = (brightness * coverage + 8) >> 4;
+	if (value > get_pixel(canvas, x, y))
+		draw_pixel(canvas, x, y, value);
+}
+
+//====================== draw arc ========================//
+/**
+ *  @brief Draws part of circle outline
+ *
+ *  Angles are in degrees, 0 points right and angles grow counterclockwise (90 points up).
+ *  Arc is drawn counterclockwise from start to end, end - start >= 360 draws whole circle.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] x0
+ *             x position of circle center
+ *  @param[in] y0
+ *             y position of circle center
+ *  @param[in] r
+ *             radius of the circle (pixels)
+ *  @param[in] start
+ *             angle of arc beginning
+ *  @param[in] end
+ *             angle of arc ending
+ * 	@param[in] brightness
+ *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
+ */
+void draw_arc(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t r, int16_t start, int16_t end, uint8_t brightness)
+{
+	arc_range range;
+	int32_t f = 1 - r;
+	int32_t ddF_y = -2 * r;
+	int32_t x = 0;
+	int32_t y = r;
+
+	arc_range_init(&range, start, end);
+
+	while (x <= y)
+	{
+		//eight symmetric points
+		const int32_t points[8][2] = { { x, y }, { -x, y }, { x, -y }, { -x, -y }, { y, x }, { -y, x }, { y, -x }, { -y, -x } };
+		for (uint8_t i = 0; i < 8; i++)
+		{
+			if (arc_range_contains(&range, points[i][0], points[i][1]))
+				plot(canvas, x0 + points[i][0], y0 + points[i][1], brightness);
+		}
+
+		if (f >= 0)
+		{
+			y--;
+			ddF_y += 2;
+			f += ddF_y;
+		}
+		x++;
+		f += 2 * x + 1;
+	}
+}
+
+//====================== draw antialiased arc ========================//
+/**
+ *  @brief Draws antialiased part of circle outline
+ *
+ *  For every column of an octant exact circle position is found with integer square root
+ *  in 1/16 pixel units and brightness is split between two neighbouring pixels.
+ *  Angles are the same as in draw_arc(). Radius can be up to 4095 pixels.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] x0
+ *             x position of circle center
+ *  @param[in] y0
+ *             y position of circle center
+ *  @param[in] r
+ *             radius of the circle (pixels)
+ *  @param[in] start
+ *             angle of arc beginning
+ *  @param[in] end
+ *             angle of arc ending
+ * 	@param[in] brightness
+ *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
+ */
+void draw_AA_arc(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t r, int16_t start, int16_t end, uint8_t brightness)
+{
+	arc_range range;
+
+	arc_range_init(&range, start, end);
+
+	for (int32_t x = 0; x <= r; x++)
+	{
+		uint32_t y16 = curves_isqrt(((uint32_t)r * r - (uint32_t)x * x) << 8);
+		int32_t y = y16 >> 4;
+		uint8_t fraction = y16 & 0x0F;
+		if (x > y)
+			break;
+
+		//inner and outer pixel of eight symmetric positions
+		for (uint8_t outer = 0; outer < 2; outer++)
+		{
+			int32_t yy = y + outer;
+			uint8_t coverage = outer ? fraction : 16 - fraction;
+			const int32_t points[8][2] = { { x, yy }, { -x, yy }, { x, -yy }, { -x, -yy }, { yy, x }, { -yy, x }, { yy, -x }, { -yy, -x } };
+			for (uint8_t i = 0; i < 8; i++)
+			{
+				if (arc_range_contains(&range, points[i][0], points[i][1]))
+					plot_AA(canvas, x0 + points[i][0], y0 + points[i][1], coverage, brightness);
+			}
+		}
+	}
+}
+
+//====================== draw pie ========================//
+/**
+ *  @brief Draws filled circle sector
+ *
+ *  Sector is drawn row by row as horizontal spans. Angles are the same as in draw_arc().
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] x0
+ *             x position of circle center
+ *  @param[in] y0
+ *             y position of circle center
+ *  @param[in] r
+ *             radius of the circle (pixels)
+ *  @param[in] start
+ *             angle of sector beginning
+ *  @param[in] end
+ *             angle of sector ending
+ * 	@param[in] brightness
+ *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
+ */
+void draw_pie(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t r, int16_t start, int16_t end, uint8_t brightness)
+{
+	arc_range range;
+
+	arc_range_init(&range, start, end);
+
+	for (int32_t dy = -r; dy <= r; dy++)
+	{
+		int32_t y = y0 + dy;
+		int32_t half = curves_isqrt((uint32_t)r * r + r - dy * dy);
+		int32_t span_start = 0;
+		uint8_t in_span = 0;
+
+		if (y < 0 || y > 0xFFFF)
+			continue;
+
+		for (int32_t dx = -half; dx <= half + 1; dx++)
+		{
+			uint8_t inside = dx <= half && arc_range_contains(&range, dx, dy);
+			if (inside && !in_span)
+			{
+				span_start = dx;
+				in_span = 1;
+			}
+			else if (!inside && in_span)
+			{
+				int32_t xs = x0 + span_start;
+				int32_t xe = x0 + dx - 1;
+				if (xe >= 0)
+					draw_hline(canvas, y, xs < 0 ? 0 : xs, xe > 0xFFFF ? 0xFFFF : xe, brightness);
+				in_span = 0;
+			}
+		}
+	}
+}
+
+//====================== antialiased segment ========================//
+/**
+ *  @brief Draws antialiased straight segment between points given in 1/16 pixel units.
+ */
+static void AA_segment(GFXcanvas *canvas, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint8_t brightness)
+{
+	uint8_t steep = abs(y1 - y0) > abs(x1 - x0);
+	int32_t tmp;
+
+	if (steep)
+	{
+		tmp = x0; x0 = y0; y0 = tmp;
+		tmp = x1; x1 = y1; y1 = tmp;
+	}
+	if (x0 > x1)
+	{
+		tmp = x0; x0 = x1; x1 = tmp;
+		tmp = y0; y0 = y1; y1 = tmp;
+	}
+
+	int32_t dx = x1 - x0;
+	int32_t dy = y1 - y0;
+
+	//every pixel column (or row for steep segment) whose center lies on the segment
+	for (int32_t c = (x0 + 15) >> 4; c <= x1 >> 4; c++)
+	{
+		int32_t y = dx ? y0 + ((c << 4) - x0) * dy / dx : y0;
+		int32_t row = y >> 4;
+		uint8_t fraction = y & 0x0F;
+
+		if (steep)
+		{
+			plot_AA(canvas, row, c, 16 - fraction, brightness);
+			plot_AA(canvas, row + 1, c, fraction, brightness);
+		}
+		else
+		{
+			plot_AA(canvas, c, row, 16 - fraction, brightness);
+			plot_AA(canvas, c, row + 1, fraction, brightness);
+		}
+	}
+}
+
+//====================== draw Bezier curve ========================//
+/**
+ *  @brief Evaluates quadratic (order 2) or cubic (order 3) Bezier curve with forward differencing.
+ *
+ *  With 2^k steps, curve position multiplied by 2^(order * k) is a polynomial with integer
+ *  coefficients, so its differences are exact integers and each step costs only additions.
+ */
+static void draw_bezier(GFXcanvas *canvas, const int32_t *px, const int32_t *py, uint8_t order, uint8_t brightness, uint8_t antialiased)
+{
+	int64_t pos[2], d1[2], d2[2], d3[2];
+	uint32_t length = 0;
+	uint8_t k = 3;
+
+	//about 4 pixels per segment, estimated from length of control polygon
+	for (uint8_t i = 0; i < order; i++)
+		length += abs(px[i + 1] - px[i]) + abs(py[i + 1] - py[i]);
+	while (k < 8 && (4UL << k) < length)
+		k++;
+
+	int64_t n = 1 << k;
+	uint8_t shift = order * k;
+	for (uint8_t axis = 0; axis < 2; axis++)
+	{
+		const int32_t *p = axis ? py : px;
+		if (order == 2)
+		{
+			int64_t a = p[0] - 2 * p[1] + p[2];
+			int64_t b = 2 * (p[1] - p[0]);
+			pos[axis] = (int64_t)p[0] << shift;
+			d1[axis] = a + b * n;
+			d2[axis] = 2 * a;
+			d3[axis] = 0;
+		}
+		else
+		{
+			int64_t a = -p[0] + 3 * p[1] - 3 * p[2] + p[3];
+			int64_t b = 3 * p[0] - 6 * p[1] + 3 * p[2];
+			int64_t c = 3 * (p[1] - p[0]);
+			pos[axis] = (int64_t)p[0] << shift;
+			d1[axis] = a + b * n + c * n * n;
+			d2[axis] = 6 * a + 2 * b * n;
+			d3[axis] = 6 * a;
+		}
+	}
+
+	//previous point in 1/16 pixel units
+	int32_t last_x = px[0] << 4;
+	int32_t last_y = py[0] << 4;
+	int64_t half = (int64_t)1 << (shift - 5);
+
+	for (int64_t i = 0; i < n; i++)
+	{
+		for (uint8_t axis = 0; axis < 2; axis++)
+		{
+			pos[axis] += d1[axis];
+			d1[axis] += d2[axis];
+			d2[axis] += d3[axis];
+		}
+		int32_t x = (pos[0] + half) >> (shift - 4);
+		int32_t y = (pos[1] + half) >> (shift - 4);
+
+		if (antialiased)
+			AA_segment(canvas, last_x, last_y, x, y, brightness);
+		else
+			draw_line(canvas, (last_x + 8) >> 4, (last_y + 8) >> 4, (x + 8) >> 4, (y + 8) >> 4, brightness);
+		last_x = x;
+		last_y = y;
+	}
+}
+
+//====================== draw quadratic Bezier curve ========================//
+/**
+ *  @brief Draws quadratic Bezier curve from (x0, y0) to (x2, y2) with control point (x1, y1).
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ * 	@param[in] brightness
+ *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
+ */
+void draw_quad_bezier(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+		uint8_t brightness)
+{
+	const int32_t px[3] = { x0, x1, x2 };
+	const int32_t py[3] = { y0, y1, y2 };
+	draw_bezier(canvas, px, py, 2, brightness, 0);
+}
+
+//====================== draw antialiased quadratic Bezier curve ========================//
+/**
+ *  @brief Draws antialiased quadratic Bezier curve from (x0, y0) to (x2, y2) with control point (x1, y1).
+ */
+void draw_AA_quad_bezier(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+		uint8_t brightness)
+{
+	const int32_t px[3] = { x0, x1, x2 };
+	const int32_t py[3] = { y0, y1, y2 };
+	draw_bezier(canvas, px, py, 2, brightness, 1);
+}
+
+//====================== draw cubic Bezier curve ========================//
+/**
+ *  @brief Draws cubic Bezier curve from (x0, y0) to (x3, y3) with control points (x1, y1) and (x2, y2).
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ * 	@param[in] brightness
+ *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
+ */
+void draw_cubic_bezier(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+		uint16_t x3, uint16_t y3, uint8_t brightness)
+{
+	const int32_t px[4] = { x0, x1, x2, x3 };
+	const int32_t py[4] = { y0, y1, y2, y3 };
+	draw_bezier(canvas, px, py, 3, brightness, 0);
+}
+
+//====================== draw antialiased cubic Bezier curve ========================//
+/**
+ *  @brief Draws antialiased cubic Bezier curve from (x0, y0) to (x3, y3) with control points (x1, y1) and (x2, y2).
+ */
+void draw_AA_cubic_bezier(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+		uint16_t x3, uint16_t y3, uint8_t brightness)
+{
+	const int32_t px[4] = { x0, x1, x2, x3 };
+	const int32_t py[4] = { y0, y1, y2, y3 };
+	draw_bezier(canvas, px, py, 3, brightness, 1);
+}
@@ -0,0 +1,49 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Curves.h
+ *
+ * \brief Arcs, pie segments and Bezier curves drawn with integer arithmetic.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_CURVES_H
+#define SSD1322_CURVES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+
+/*============ functions ============*/
+
+uint32_t curves_isqrt(uint32_t value);
+int16_t curves_sin_deg(int16_t angle);
+int16_t curves_cos_deg(int16_t angle);
+
+void draw_arc(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t r, int16_t start, int16_t end, uint8_t brightness);
+void draw_AA_arc(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t r, int16_t start, int16_t end, uint8_t brightness);
+void draw_pie(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t r, int16_t start, int16_t end, uint8_t brightness);
+
+void draw_quad_bezier(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+		uint8_t brightness);
+void draw_AA_quad_bezier(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+		uint8_t brightness);
+void draw_cubic_bezier(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+		uint16_t x3, uint16_t y3, uint8_t brightness);
+void draw_AA_cubic_bezier(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2,
+		uint16_t x3, uint16_t y3, uint8_t brightness);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_CURVES_H */
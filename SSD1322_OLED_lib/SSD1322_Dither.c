@@ -0,0 +1,222 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Dither.c
+ *
+ * \brief Error diffusion dithering of 8 bits per pixel images to 4 bits per pixel at runtime.
+ *
+ * Every pixel is rounded to the nearest of 16 levels (0, 17, ... 255) and the rounding error
+ * is spread to pixels that were not converted yet. Floyd-Steinberg gives 7/16 to the right
+ * neighbour and 3/16, 5/16, 1/16 to the row below. Sierra Lite gives 2/4 to the right and
+ * 1/4 below left and below. Arithmetic is the same as in SSD1322_Assets.hpp, so runtime
+ * and compile time conversion give identical bitmaps.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Dither.h"
+
+#include <string.h>
+
+//====================== quantize pixel ========================//
+/**
+ *  @brief Reduces 8-bit value (with accumulated error) to the nearest of 16 levels 0, 17, ... 255.
+ */
+static inline uint8_t nearest_level(int16_t value)
+{
+	if (value <= 0)
+		return 0;
+	if (value >= 255)
+		return 15;
+	return (value + 8) / 17;
+}
+
+//====================== init dithering ========================//
+/**
+ *  @brief Prepares conversion of a new image.
+ *
+ *  @param[in] dither
+ *             state to prepare
+ *  @param[in] method
+ *             DITHER_NONE, DITHER_FLOYD_STEINBERG or DITHER_SIERRA_LITE
+ *  @param[in] width
+ *             width of image in pixels
+ *  @param[in] work
+ *             array of DITHER_WORK_SIZE(width) elements, has to stay valid until image is converted
+ */
+void dither_init(GFXdither *dither, uint8_t method, uint16_t width, int16_t *work)
+{
+	dither->method = method;
+	dither->width = width;
+	dither->x = 0;
+	dither->row = 0;
+	dither->error = work;
+	memset(work, 0, DITHER_WORK_SIZE(width) * sizeof(int16_t));
+}
+
+//====================== convert pixels ========================//
+/**
+ *  @brief Converts next pixels of image and writes them packed, 2 pixels per byte.
+ *
+ *  Pixels are taken row after row, a call can end in the middle of a row and the next call
+ *  continues from there.
+ *
+ *  @param[in] dither
+ *             state prepared with dither_init()
+ *  @param[in] src
+ *             8 bits per pixel values
+ *  @param[in] count
+ *             amount of pixels to convert
+ *  @param[out] dst
+ *             packed 4 bits per pixel output, even pixels in high nibble
+ *  @param[in] position
+ *             index of pixel in dst where first result is written, other nibbles are kept
+ */
+void dither_pixels(GFXdither *dither, const uint8_t *src, uint32_t count, uint8_t *dst, uint16_t position)
+{
+	uint16_t stride = dither->width + 2;
+	int16_t *current = dither->error + dither->row * stride;
+	int16_t *next = dither->error + (dither->row ^ 1) * stride;
+	uint8_t *byte = dst + position / 2;
+	uint8_t high = !(position & 1);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint16_t x = dither->x;
+		int16_t value = src[i];
+		uint8_t level;
+
+		//errors are stored shifted by one, so x - 1 of first pixel is a valid index
+		if (dither->method == DITHER_FLOYD_STEINBERG)
+		{
+			value += current[x + 1];
+			level = nearest_level(value);
+			int16_t diff = value - level * 17;
+			current[x + 2] += diff * 7 / 16;
+			next[x] += diff * 3 / 16;
+			next[x + 1] += diff * 5 / 16;
+			next[x + 2] += diff / 16;
+		}
+		else if (dither->method == DITHER_SIERRA_LITE)
+		{
+			value += current[x + 1];
+			level = nearest_level(value);
+			int16_t diff = value - level * 17;
+			current[x + 2] += diff * 2 / 4;
+			next[x] += diff / 4;
+			next[x + 1] += diff / 4;
+		}
+		else
+		{
+			level = value >> 4;
+		}
+
+		if (high)
+		{
+			*byte = (*byte & 0x0F) | (level << 4);
+		}
+		else
+		{
+			*byte = (*byte & 0xF0) | level;
+			byte++;
+		}
+		high = !high;
+
+		//end of row - errors of next row become current ones
+		if (++dither->x == dither->width)
+		{
+			int16_t *tmp = current;
+			current = next;
+			next = tmp;
+			memset(next, 0, stride * sizeof(int16_t));
+			dither->row ^= 1;
+			dither->x = 0;
+		}
+	}
+}
+
+//====================== draw dithered row ========================//
+/**
+ *  @brief Converts next row of image and draws it
+ *
+ *  If canvas is not rotated and row fits in clipping area, it is written straight into frame buffer.
+ *  Rows outside of canvas are converted too, so errors are spread correctly.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] dither
+ *             state prepared with dither_init(), at the beginning of a row
+ *  @param[in] src
+ *             dither->width pixels, 8 bits per pixel
+ *  @param[in] x0
+ *             x position of first pixel of the row
+ *  @param[in] y
+ *             y position of the row
+ */
+void draw_dithered_row(GFXcanvas *canvas, GFXdither *dither, const uint8_t *src, uint16_t x0, uint16_t y)
+{
+	uint16_t width = dither->width;
+	uint8_t chunk[16];
+
+	if (canvas->rotation == GFX_ROTATION_0 && x0 >= canvas->clip.x0 && (uint32_t)x0 + width - 1 <= canvas->clip.x1
+			&& y >= canvas->clip.y0 && y <= canvas->clip.y1)
+	{
+		dither_pixels(dither, src, width, canvas->buffer + (uint32_t)y * canvas->stride, x0);
+		return;
+	}
+
+	//clipped or rotated - row is converted in pieces and drawn pixel by pixel
+	for (uint16_t x = 0; x < width; x += 32)
+	{
+		uint16_t count = width - x > 32 ? 32 : width - x;
+		dither_pixels(dither, src + x, count, chunk, 0);
+		for (uint16_t i = 0; i < count; i++)
+		{
+			draw_pixel(canvas, x0 + x + i, y, (i & 1) ? chunk[i / 2] & 0x0F : chunk[i / 2] >> 4);
+		}
+	}
+}
+
+//====================== draw dithered 8-bit bitmap ========================//
+/**
+ *  @brief Draws 8 bits per pixel bitmap reduced to 16 levels with dithering
+ *
+ *  Bitmap format is the same as in draw_bitmap_8bpp().
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] bitmap
+ *             array with pixels, 8 bits per pixel
+ *  @param[in] x0
+ *             x position of top left corner of drawn bitmap
+ *  @param[in] y0
+ *             y position of top left corner of drawn bitmap
+ *  @param[in] x_size
+ *             width of bitmap in pixels
+ *  @param[in] y_size
+ *             height of bitmap in pixels
+ *  @param[in] method
+ *             DITHER_NONE, DITHER_FLOYD_STEINBERG or DITHER_SIERRA_LITE
+ *  @param[in] work
+ *             array of DITHER_WORK_SIZE(x_size) elements
+ */
+void draw_bitmap_dithered(GFXcanvas *canvas, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size,
+		uint8_t method, int16_t *work)
+{
+	GFXdither dither;
+
+	if (x_size == 0 || y_size == 0)
+		return;
+
+	dither_init(&dither, method, x_size, work);
+	for (uint16_t y = 0; y < y_size; y++)
+	{
+		draw_dithered_row(canvas, &dither, bitmap + (uint32_t)y * x_size, x0, y0 + y);
+	}
+}
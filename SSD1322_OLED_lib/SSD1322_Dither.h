@@ -0,0 +1,60 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Dither.h
+ *
+ * \brief Error diffusion dithering of 8 bits per pixel images to 4 bits per pixel at runtime.
+ *
+ * Pixels are converted as a stream, row after row, so images can come from camera, sensor
+ * or file in small parts. Only two rows of errors are kept in memory.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_DITHER_H
+#define SSD1322_DITHER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+
+/*============ defines ============*/
+
+#define DITHER_NONE            0    ///< Lower 4 bits are cut off, same as draw_bitmap_8bpp()
+#define DITHER_FLOYD_STEINBERG 1    ///< Error spread to 4 neighbours, best quality
+#define DITHER_SIERRA_LITE     2    ///< Error spread to 3 neighbours, faster
+
+// Amount of int16_t elements of work array for images of given width
+#define DITHER_WORK_SIZE(width)  (2 * ((width) + 2))
+
+/*============ dither structure ============*/
+
+typedef struct {
+  uint8_t method;        ///< DITHER_NONE, DITHER_FLOYD_STEINBERG or DITHER_SIERRA_LITE
+  uint16_t width;        ///< Width of image in pixels
+  uint16_t x;            ///< Position of next pixel in its row
+  uint8_t row;           ///< 0 or 1, selects which half of work holds errors of current row
+  int16_t *error;        ///< Errors of current and next row
+} GFXdither;
+
+/*============ functions ============*/
+
+void dither_init(GFXdither *dither, uint8_t method, uint16_t width, int16_t *work);
+void dither_pixels(GFXdither *dither, const uint8_t *src, uint32_t count, uint8_t *dst, uint16_t position);
+void draw_dithered_row(GFXcanvas *canvas, GFXdither *dither, const uint8_t *src, uint16_t x0, uint16_t y);
+void draw_bitmap_dithered(GFXcanvas *canvas, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size,
+		uint8_t method, int16_t *work);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_DITHER_H */
@@ -0,0 +1,431 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Fill.c
+ *
+ * \brief Gradient and pattern fills of rectangles and other shapes made of horizontal spans.
+ *
+ * Spans are generated a row at a time: brightness is stepped with fixed point additions along
+ * the row and pixel pairs are written to frame buffer as whole bytes. Linear gradient adds
+ * constant step per pixel. Radial gradient updates squared distance with additions
+ * and follows its square root incrementally, so only one square root is computed per row.
+ * Gradients are smoothed with 4x4 Bayer ordered dithering, which hides 16 level banding.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Curves.h"
+#include "../SSD1322_OLED_lib/SSD1322_Fill.h"
+
+// 4x4 Bayer threshold matrix
+static const uint8_t bayer[4][4] = {
+		{ 0, 8, 2, 10 },
+		{ 12, 4, 14, 6 },
+		{ 3, 11, 1, 9 },
+		{ 15, 7, 13, 5 }
+};
+
+//====================== patterns ========================//
+const uint8_t pattern_hatch_horizontal[8] = { 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00 };
+const uint8_t pattern_hatch_vertical[8] = { 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88 };
+const uint8_t pattern_hatch_diagonal[8] = { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+const uint8_t pattern_hatch_cross[8] = { 0xFF, 0x88, 0x88, 0x88, 0xFF, 0x88, 0x88, 0x88 };
+const uint8_t pattern_checker[8] = { 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55 };
+
+// Writes packed pixels, two nibbles are combined into one byte store
+typedef struct {
+	uint8_t *byte;
+	uint8_t pending;    ///< High nibble waiting for its pair
+	uint8_t high;       ///< 1 if next pixel goes to high nibble
+} nibble_writer;
+
+//====================== start writing ========================//
+static void writer_start(nibble_writer *writer, uint8_t *row, uint16_t x)
+{
+	writer->byte = row + x / 2;
+	writer->high = !(x & 1);
+	//kept high nibble is needed only when writing starts at odd x
+	writer->pending = (x & 1) ? *writer->byte & 0xF0 : 0;
+}
+
+//====================== write pixel ========================//
+static inline void writer_put(nibble_writer *writer, uint8_t brightness)
+{
+	if (writer->high)
+	{
+		writer->pending = brightness << 4;
+		writer->high = 0;
+	}
+	else
+	{
+		*writer->byte++ = writer->pending | brightness;
+		writer->high = 1;
+	}
+}
+
+//====================== finish writing ========================//
+static void writer_end(nibble_writer *writer)
+{
+	if (!writer->high)
+		*writer->byte = writer->pending | (*writer->byte & 0x0F);
+}
+
+//====================== rounding offsets ========================//
+/**
+ *  @brief Gives offsets added to 16.16 brightness before dropping fraction, for 4 pixels from x.
+ */
+static void row_thresholds(const GFXfill *fill, uint16_t x, uint16_t y, int32_t thresholds[4])
+{
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		if (fill->dither)
+			thresholds[i] = bayer[y & 3][(x + i) & 3] * 4096 + 2048;
+		else
+			thresholds[i] = 32768;
+	}
+}
+
+//====================== generate row ========================//
+/**
+ *  @brief Computes count pixels of drawing row y starting at drawing x and writes them packed.
+ *
+ *  @param[in] row
+ *             packed destination row
+ *  @param[in] position
+ *             pixel index in destination row where first pixel is written
+ */
+static void generate_row(const GFXfill *fill, uint8_t *row, uint16_t position, uint16_t x, uint16_t y, uint16_t count)
+{
+	nibble_writer writer;
+	int32_t thresholds[4];
+	uint8_t phase = 0;
+
+	writer_start(&writer, row, position);
+	row_thresholds(fill, x, y, thresholds);
+
+	if (fill->type == FILL_PATTERN)
+	{
+		uint8_t size = fill->pattern_size;
+		uint8_t bits = fill->pattern[y % size];
+		uint8_t column = x % size;
+		for (uint16_t i = 0; i < count; i++)
+		{
+			writer_put(&writer, (bits >> (size - 1 - column)) & 1 ? fill->brightness1 : fill->brightness0);
+			if (++column == size)
+				column = 0;
+		}
+	}
+	else if (fill->type == FILL_LINEAR)
+	{
+		int32_t low = (fill->brightness0 < fill->brightness1 ? fill->brightness0 : fill->brightness1) << 16;
+		int32_t high = (fill->brightness0 < fill->brightness1 ? fill->brightness1 : fill->brightness0) << 16;
+		int64_t start = ((int64_t)fill->brightness0 << 16) + (int64_t)(x - fill->x) * fill->step_x
+				+ (int64_t)(y - fill->y) * fill->step_y;
+		int32_t level = start < -0x40000000 ? -0x40000000 : start > 0x40000000 ? 0x40000000 : start;
+
+		for (uint16_t i = 0; i < count; i++)
+		{
+			int32_t value = level < low ? low : level > high ? high : level;
+			writer_put(&writer, (value + thresholds[phase]) >> 16);
+			phase = (phase + 1) & 3;
+			level += fill->step_x;
+		}
+	}
+	else
+	{
+		//distances are in 1/16 pixel, squares fit 32 bits for radius up to 4095
+		uint32_t limit = (uint32_t)fill->radius * 16;
+		uint32_t limit_square = limit * limit;
+		int32_t dx = x - fill->x;
+		int32_t dy = y - fill->y;
+		int64_t square = ((int64_t)dx * dx + (int64_t)dy * dy) * 256;
+		uint32_t distance = 0;
+		uint8_t inside = 0;
+
+		for (uint16_t i = 0; i < count; i++)
+		{
+			int32_t value;
+
+			if (square <= limit_square)
+			{
+				//distance changes by at most 1 pixel between neighbours
+				if (!inside)
+					distance = curves_isqrt(square);
+				while ((distance + 1) * (distance + 1) <= square)
+					distance++;
+				while (distance * distance > square)
+					distance--;
+				inside = 1;
+				value = ((int32_t)fill->brightness0 << 16) + (int32_t)distance * fill->step_r;
+			}
+			else
+			{
+				inside = 0;
+				value = (int32_t)fill->brightness1 << 16;
+			}
+			writer_put(&writer, (value + thresholds[phase]) >> 16);
+			phase = (phase + 1) & 3;
+
+			square += (int64_t)(2 * dx + 1) * 256;
+			dx++;
+		}
+	}
+
+	writer_end(&writer);
+}
+
+//====================== linear gradient ========================//
+/**
+ *  @brief Prepares gradient that changes along line from (x0, y0) to (x1, y1).
+ *
+ *  Pixels before start have brightness0 and pixels after end have brightness1.
+ *
+ *  @param[in] fill
+ *             fill to prepare
+ *  @param[in] x0
+ *             x position of gradient start
+ *  @param[in] y0
+ *             y position of gradient start
+ *  @param[in] x1
+ *             x position of gradient end
+ *  @param[in] y1
+ *             y position of gradient end
+ *  @param[in] brightness0
+ *             brightness at start (range 0-15 dec or 0x00-0x0F hex)
+ *  @param[in] brightness1
+ *             brightness at end (range 0-15 dec or 0x00-0x0F hex)
+ */
+void fill_linear(GFXfill *fill, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t brightness0, uint8_t brightness1)
+{
+	int64_t dx = x1 - x0;
+	int64_t dy = y1 - y0;
+	int64_t length_square = dx * dx + dy * dy;
+	int64_t change = ((int64_t)brightness1 - brightness0) * 65536;
+
+	fill->type = FILL_LINEAR;
+	fill->brightness0 = brightness0;
+	fill->brightness1 = brightness1;
+	fill->dither = 1;
+	fill->x = x0;
+	fill->y = y0;
+	fill->step_x = length_square ? change * dx / length_square : 0;
+	fill->step_y = length_square ? change * dy / length_square : 0;
+}
+
+//====================== radial gradient ========================//
+/**
+ *  @brief Prepares gradient that changes with distance from center.
+ *
+ *  @param[in] fill
+ *             fill to prepare
+ *  @param[in] x
+ *             x position of center
+ *  @param[in] y
+ *             y position of center
+ *  @param[in] radius
+ *             distance where brightness1 is reached, up to 4095 pixels
+ *  @param[in] brightness0
+ *             brightness at center (range 0-15 dec or 0x00-0x0F hex)
+ *  @param[in] brightness1
+ *             brightness at radius and further (range 0-15 dec or 0x00-0x0F hex)
+ */
+void fill_radial(GFXfill *fill, int16_t x, int16_t y, uint16_t radius, uint8_t brightness0, uint8_t brightness1)
+{
+	if (radius > 4095)
+		radius = 4095;
+
+	fill->type = FILL_RADIAL;
+	fill->brightness0 = brightness0;
+	fill->brightness1 = brightness1;
+	fill->dither = 1;
+	fill->x = x;
+	fill->y = y;
+	fill->radius = radius;
+	fill->step_r = radius ? ((int32_t)brightness1 - brightness0) * 4096 / radius : 0;
+}
+
+//====================== pattern ========================//
+/**
+ *  @brief Prepares fill with repeated two level pattern.
+ *
+ *  Pattern is aligned to drawing coordinates, so neighbouring shapes join seamlessly.
+ *
+ *  @param[in] fill
+ *             fill to prepare
+ *  @param[in] pattern
+ *             size rows, bit 7 (size 8) or bit 3 (size 4) is the leftmost pixel, set bits are on
+ *  @param[in] size
+ *             4 or 8
+ *  @param[in] brightness0
+ *             brightness of pixels that are off
+ *  @param[in] brightness1
+ *             brightness of pixels that are on
+ */
+void fill_pattern(GFXfill *fill, const uint8_t *pattern, uint8_t size, uint8_t brightness0, uint8_t brightness1)
+{
+	fill->type = FILL_PATTERN;
+	fill->brightness0 = brightness0;
+	fill->brightness1 = brightness1;
+	fill->dither = 0;
+	fill->pattern_size = size == 4 ? 4 : 8;
+	for (uint8_t i = 0; i < fill->pattern_size; i++)
+	{
+		fill->pattern[i] = pattern[i];
+	}
+}
+
+//====================== Bayer pattern ========================//
+/**
+ *  @brief Prepares 4x4 ordered dither pattern with level of 16 pixels on.
+ *
+ *  Gives 17 evenly spread mixes of two brightness values.
+ *
+ *  @param[in] fill
+ *             fill to prepare
+ *  @param[in] level
+ *             amount of pixels that are on in every 4x4 block, 0-16
+ *  @param[in] brightness0
+ *             brightness of pixels that are off
+ *  @param[in] brightness1
+ *             brightness of pixels that are on
+ */
+void fill_bayer(GFXfill *fill, uint8_t level, uint8_t brightness0, uint8_t brightness1)
+{
+	uint8_t pattern[4] = { 0, 0, 0, 0 };
+
+	for (uint8_t y = 0; y < 4; y++)
+	{
+		for (uint8_t x = 0; x < 4; x++)
+		{
+			if (bayer[y][x] < level)
+				pattern[y] |= 0x08 >> x;
+		}
+	}
+	fill_pattern(fill, pattern, 4, brightness0, brightness1);
+}
+
+//====================== fill span ========================//
+/**
+ *  @brief Fills horizontal span, basic block of filled shapes
+ *
+ *  Without rotation row is written straight into frame buffer. Rotated canvas is filled
+ *  through draw_pixel(), because drawing row is a frame buffer column.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] fill
+ *             gradient or pattern
+ *  @param[in] y
+ *             row of the span
+ *  @param[in] x0
+ *             first pixel of the span
+ *  @param[in] x1
+ *             last pixel of the span
+ */
+void fill_span(GFXcanvas *canvas, const GFXfill *fill, uint16_t y, uint16_t x0, uint16_t x1)
+{
+	if (x0 > x1)
+	{
+		uint16_t tmp = x0;
+		x0 = x1;
+		x1 = tmp;
+	}
+
+	if (canvas->rotation == GFX_ROTATION_0)
+	{
+		if (y < canvas->clip.y0 || y > canvas->clip.y1 || x1 < canvas->clip.x0 || x0 > canvas->clip.x1)
+			return;
+		if (x0 < canvas->clip.x0)
+			x0 = canvas->clip.x0;
+		if (x1 > canvas->clip.x1)
+			x1 = canvas->clip.x1;
+		generate_row(fill, canvas->buffer + (uint32_t)y * canvas->stride, x0, x0, y, x1 - x0 + 1);
+		return;
+	}
+
+	//rotated canvas - row is generated in pieces and drawn pixel by pixel, writer_end() reads last byte of odd pieces
+	uint8_t chunk[16] = { 0 };
+	uint16_t width = (canvas->rotation & 1) ? canvas->height : canvas->width;
+	if (x1 >= width)
+		x1 = width - 1;
+
+	for (uint32_t x = x0; x <= x1; x += 32)
+	{
+		uint16_t count = x1 - x + 1 > 32 ? 32 : x1 - x + 1;
+		generate_row(fill, chunk, 0, x, y, count);
+		for (uint16_t i = 0; i < count; i++)
+		{
+			draw_pixel(canvas, x + i, y, (i & 1) ? chunk[i / 2] & 0x0F : chunk[i / 2] >> 4);
+		}
+	}
+}
+
+//====================== fill rectangle ========================//
+/**
+ *  @brief Fills rectangle with gradient or pattern
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] fill
+ *             gradient or pattern
+ *  @param[in] x0
+ *             x position of upper left corner
+ *  @param[in] y0
+ *             y position of upper left corner
+ *  @param[in] x1
+ *             x position of lower right corner
+ *  @param[in] y1
+ *             y position of lower right corner
+ */
+void fill_rect(GFXcanvas *canvas, const GFXfill *fill, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+	if (y0 > y1)
+	{
+		uint16_t tmp = y0;
+		y0 = y1;
+		y1 = tmp;
+	}
+
+	for (uint32_t y = y0; y <= y1; y++)
+	{
+		fill_span(canvas, fill, y, x0, x1);
+	}
+}
+
+//====================== fill circle ========================//
+/**
+ *  @brief Fills circle with gradient or pattern
+ *
+ *  Circle covers the same pixels as draw_pie() called with full angle.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] fill
+ *             gradient or pattern
+ *  @param[in] x0
+ *             x position of circle center
+ *  @param[in] y0
+ *             y position of circle center
+ *  @param[in] r
+ *             radius of the circle (pixels)
+ */
+void fill_circle(GFXcanvas *canvas, const GFXfill *fill, uint16_t x0, uint16_t y0, uint16_t r)
+{
+	for (int32_t dy = -r; dy <= r; dy++)
+	{
+		int32_t y = y0 + dy;
+		int32_t half = curves_isqrt((uint32_t)r * r + r - dy * dy);
+		int32_t left = x0 - half;
+		int32_t right = x0 + half;
+
+		if (y < 0 || y > 0xFFFF || right < 0)
+			continue;
+		fill_span(canvas, fill, y, left < 0 ? 0 : left, right > 0xFFFF ? 0xFFFF : right);
+	}
+}
@@ -0,0 +1,73 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Fill.h
+ *
+ * \brief Gradient and pattern fills of rectangles and other shapes made of horizontal spans.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_FILL_H
+#define SSD1322_FILL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+
+/*============ defines ============*/
+
+#define FILL_LINEAR  0
+#define FILL_RADIAL  1
+#define FILL_PATTERN 2
+
+/*============ fill structure ============*/
+
+// Way of computing brightness of filled pixels, prepared with fill_linear(), fill_radial(), fill_pattern() or fill_bayer()
+typedef struct {
+  uint8_t type;          ///< FILL_LINEAR, FILL_RADIAL or FILL_PATTERN
+  uint8_t brightness0;   ///< Brightness at gradient start, or of pattern pixels that are off
+  uint8_t brightness1;   ///< Brightness at gradient end, or of pattern pixels that are on
+  uint8_t dither;        ///< 1 to smooth gradient steps with ordered dithering (default), 0 for flat bands
+  int16_t x;             ///< Gradient start point or radial gradient center
+  int16_t y;             ///< Gradient start point or radial gradient center
+  int32_t step_x;        ///< Linear gradient: brightness change per pixel along x axis, 1/65536 units
+  int32_t step_y;        ///< Linear gradient: brightness change per pixel along y axis, 1/65536 units
+  uint16_t radius;       ///< Radial gradient: distance where brightness1 is reached
+  int32_t step_r;        ///< Radial gradient: brightness change per 1/16 pixel of distance, 1/65536 units
+  uint8_t pattern[8];    ///< Pattern rows, most significant used bit is the leftmost pixel
+  uint8_t pattern_size;  ///< Pattern is 4x4 or 8x8 pixels
+} GFXfill;
+
+/*============ patterns ============*/
+
+extern const uint8_t pattern_hatch_horizontal[8];
+extern const uint8_t pattern_hatch_vertical[8];
+extern const uint8_t pattern_hatch_diagonal[8];
+extern const uint8_t pattern_hatch_cross[8];
+extern const uint8_t pattern_checker[8];
+
+/*============ functions ============*/
+
+void fill_linear(GFXfill *fill, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t brightness0, uint8_t brightness1);
+void fill_radial(GFXfill *fill, int16_t x, int16_t y, uint16_t radius, uint8_t brightness0, uint8_t brightness1);
+void fill_pattern(GFXfill *fill, const uint8_t *pattern, uint8_t size, uint8_t brightness0, uint8_t brightness1);
+void fill_bayer(GFXfill *fill, uint8_t level, uint8_t brightness0, uint8_t brightness1);
+
+void fill_span(GFXcanvas *canvas, const GFXfill *fill, uint16_t y, uint16_t x0, uint16_t x1);
+void fill_rect(GFXcanvas *canvas, const GFXfill *fill, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+void fill_circle(GFXcanvas *canvas, const GFXfill *fill, uint16_t x0, uint16_t y0, uint16_t r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_FILL_H */
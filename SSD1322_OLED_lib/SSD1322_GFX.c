@@ -18,51 +18,336 @@
 #include "../SSD1322_OLED_lib/SSD1322_GFX.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
-const GFXfont *gfx_font = NULL;     //pointer to Adafruit font that is currently selected
+static void rotate_point(const GFXcanvas *canvas, uint16_t *x, uint16_t *y);
 
-uint16_t _buffer_height = 64;       //buffer dimensions used to determine if pixel is within array bounds
-uint16_t _buffer_width = 256;      //by default buffer size is equal to OLED size
+//====================== init canvas ========================//
+/**
+ *  @brief Prepares canvas over a frame buffer
+ *
+ *  Canvas keeps everything drawing functions need - buffer, its dimensions, selected font,
+ *  clipping rectangle and rotation - so any number of canvases can be drawn independently,
+ *  also from different threads.
+ *
+ *  Rows of the canvas are (width / 2) bytes long. To draw on a part of bigger frame buffer,
+ *  change stride to the row length of that buffer after this call. Canvas is sent to
+ *  SSD1322_HW_default_device, other display can be set in device field.
+ *
+ *  @param[out] canvas
+ *             canvas to prepare
+ *  @param[in] buffer
+ *             array of pixel values, (width * height / 2) bytes long
+ *  @param[in] width
+ *             width of the buffer in pixels, has to be even
+ *  @param[in] height
+ *  		   height of the buffer in pixels
+ */
+void canvas_init(GFXcanvas *canvas, uint8_t *buffer, uint16_t width, uint16_t height)
+{
+	canvas->buffer = buffer;
+	canvas->width = width;
+	canvas->height = height;
+	canvas->stride = width / 2;
+	canvas->font = NULL;
+	canvas->rotation = GFX_ROTATION_0;
+	canvas->device = &SSD1322_HW_default_device;
+	canvas_reset_clip(canvas);
+}
+
+//====================== set clipping rectangle ========================//
+/**
+ *  @brief Limits drawing to a rectangle
+ *
+ *  Pixels outside clipping rectangle are not drawn. Rectangle is given in drawing coordinates,
+ *  so it should be set after set_rotation(). Parts outside of the canvas are cut off.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] clip
+ *             area that can be drawn on
+ */
+void canvas_set_clip(GFXcanvas *canvas, const GFXrect *clip)
+{
+	uint16_t x0 = clip->x0, y0 = clip->y0, x1 = clip->x1, y1 = clip->y1;
+	rotate_point(canvas, &x0, &y0);
+	rotate_point(canvas, &x1, &y1);
+
+	canvas->clip.x0 = x0 < x1 ? x0 : x1;
+	canvas->clip.x1 = x0 < x1 ? x1 : x0;
+	canvas->clip.y0 = y0 < y1 ? y0 : y1;
+	canvas->clip.y1 = y0 < y1 ? y1 : y0;
+	if (canvas->clip.x1 > canvas->width - 1)
+		canvas->clip.x1 = canvas->width - 1;
+	if (canvas->clip.y1 > canvas->height - 1)
+		canvas->clip.y1 = canvas->height - 1;
+}
+
+//====================== reset clipping rectangle ========================//
+/**
+ *  @brief Allows drawing on the whole canvas again
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ */
+void canvas_reset_clip(GFXcanvas *canvas)
+{
+	canvas->clip.x0 = 0;
+	canvas->clip.y0 = 0;
+	canvas->clip.x1 = canvas->width - 1;
+	canvas->clip.y1 = canvas->height - 1;
+}
+
+//====================== set rotation ========================//
+/**
+ *  @brief Sets rotation of drawing coordinates
+ *
+ *  All drawing functions transform their coordinates to frame buffer coordinates once per shape,
+ *  so rotated drawing is almost as fast as normal one. With GFX_ROTATION_90 and GFX_ROTATION_270
+ *  width and height of drawing area are swapped - 256x64 frame buffer becomes 64x256 portrait canvas.
+ *
+ *  If the whole display is mounted upside down, it is better to leave GFX_ROTATION_0 and use
+ *  SSD1322_API_set_orientation(), which rotates picture in display controller at no cost.
+ *
+ *  Functions that send buffer to OLED and modules using frame buffer directly (animations,
+ *  sprites) always use frame buffer coordinates.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] rotation
+ *             GFX_ROTATION_0, GFX_ROTATION_90, GFX_ROTATION_180 or GFX_ROTATION_270 (clockwise)
+ */
+void set_rotation(GFXcanvas *canvas, uint8_t rotation)
+{
+	canvas->rotation = rotation & 0x03;
+}
+
+//====================== rotate point ========================//
+/**
+ *  @brief Transforms drawing coordinates to frame buffer coordinates.
+ */
+static void rotate_point(const GFXcanvas *canvas, uint16_t *x, uint16_t *y)
+{
+	uint16_t tmp;
+
+	switch (canvas->rotation)
+	{
+	case GFX_ROTATION_90:
+		tmp = *x;
+		*x = canvas->width - 1 - *y;
+		*y = tmp;
+		break;
+	case GFX_ROTATION_180:
+		*x = canvas->width - 1 - *x;
+		*y = canvas->height - 1 - *y;
+		break;
+	case GFX_ROTATION_270:
+		tmp = *y;
+		*y = canvas->height - 1 - *x;
+		*x = tmp;
+		break;
+	}
+}
+
+//====================== rotate signed point ========================//
+/**
+ *  @brief Transforms drawing coordinates to frame buffer coordinates without wrapping around.
+ *
+ *  Points beyond the canvas stay beyond it after rotation, frame buffer coordinates can be negative.
+ */
+static void rotate_point_signed(const GFXcanvas *canvas, int32_t *x, int32_t *y)
+{
+	int32_t tmp;
+
+	switch (canvas->rotation)
+	{
+	case GFX_ROTATION_90:
+		tmp = *x;
+		*x = canvas->width - 1 - *y;
+		*y = tmp;
+		break;
+	case GFX_ROTATION_180:
+		*x = canvas->width - 1 - *x;
+		*y = canvas->height - 1 - *y;
+		break;
+	case GFX_ROTATION_270:
+		tmp = *y;
+		*y = canvas->height - 1 - *x;
+		*x = tmp;
+		break;
+	}
+}
 
-//====================== set buffer size ========================//
+//====================== clip span ========================//
 /**
- *  @brief Overwrites expected frame buffer dimensions
+ *  @brief Orders ends of a span and cuts them to drawing area of given size.
  *
- *	Buffer size is used in draw_pixel() function to determine if pixel is within array bounds.
+ *  Lines and rectangles are cut in drawing coordinates, before rotation, so their ends beyond
+ *  the canvas can't wrap around to the opposite edge when they are rotated.
  *
- *  By default frame buffer size is 256x64 - equal to size of OLED screen. You may want to change it,
- *  for example to use scrolling effet.
+ *  @return 0 if nothing of the span is left
+ */
+static uint8_t clip_span(uint16_t size, uint16_t *a0, uint16_t *a1)
+{
+	if (*a0 > *a1)
+	{
+		uint16_t tmp = *a0;
+		*a0 = *a1;
+		*a1 = tmp;
+	}
+	if (*a0 >= size)
+		return 0;
+	if (*a1 >= size)
+		*a1 = size - 1;
+	return 1;
+}
+
+//====================== rotation steps ========================//
+/**
+ *  @brief Gives frame buffer steps corresponding to one pixel step along drawing x and y axis.
  *
- *  @param[in] buffer_width
- *             new x size of a buffer in pixels
- *  @param[in] buffer_height
- *  		   new y size of a buffer in pixels
+ *  Used by shapes that walk over pixels (bitmaps, characters) to compute frame buffer position
+ *  incrementally instead of rotating every pixel.
+ */
+static void rotation_steps(const GFXcanvas *canvas, int8_t *x_dx, int8_t *x_dy, int8_t *y_dx, int8_t *y_dy)
+{
+	static const int8_t steps[4][4] = {
+			{ 1, 0, 0, 1 },    //GFX_ROTATION_0
+			{ 0, 1, -1, 0 },   //GFX_ROTATION_90
+			{ -1, 0, 0, -1 },  //GFX_ROTATION_180
+			{ 0, -1, 1, 0 }    //GFX_ROTATION_270
+	};
+
+	*x_dx = steps[canvas->rotation][0];
+	*x_dy = steps[canvas->rotation][1];
+	*y_dx = steps[canvas->rotation][2];
+	*y_dy = steps[canvas->rotation][3];
+}
+
+//====================== put pixel ========================//
+/**
+ *  @brief Writes one pixel at frame buffer coordinates, ignoring rotation.
+ */
+static void put_pixel(GFXcanvas *canvas, uint16_t x, uint16_t y, uint8_t brightness)
+{
+	if (x < canvas->clip.x0 || x > canvas->clip.x1 || y < canvas->clip.y0 || y > canvas->clip.y1)
+		return;
+
+	uint8_t *byte = canvas->buffer + (uint32_t)y * canvas->stride + x / 2;
+	if (x % 2 == 1)
+	{
+		*byte = (*byte & 0xF0) | brightness;
+	}
+	else
+	{
+		*byte = (*byte & 0x0F) | (brightness << 4);
+	}
+}
+
+//====================== put signed pixel ========================//
+/**
+ *  @brief Writes one pixel at frame buffer coordinates that can be negative, see rotate_point_signed().
  */
+static void put_pixel_signed(GFXcanvas *canvas, int32_t x, int32_t y, uint8_t brightness)
+{
+	if (x < 0 || y < 0 || x > 0xFFFF || y > 0xFFFF)
+		return;
+	put_pixel(canvas, x, y, brightness);
+}
+
+//====================== put vertical line ========================//
+/**
+ *  @brief Writes vertical line at frame buffer coordinates, ignoring rotation.
+ */
+static void put_vline(GFXcanvas *canvas, uint16_t x, uint16_t y0, uint16_t y1, uint8_t brightness)
+{
+	if (y0 > y1)
+	{
+		uint16_t tmp = y0;
+		y0 = y1;
+		y1 = tmp;
+	}
+	if (x < canvas->clip.x0 || x > canvas->clip.x1 || y1 < canvas->clip.y0 || y0 > canvas->clip.y1)
+		return;
+	if (y0 < canvas->clip.y0)
+		y0 = canvas->clip.y0;
+	if (y1 > canvas->clip.y1)
+		y1 = canvas->clip.y1;
 
+	uint8_t *byte = canvas->buffer + (uint32_t)y0 * canvas->stride + x / 2;
+	uint8_t mask = (x % 2 == 1) ? 0xF0 : 0x0F;
+	uint8_t value = (x % 2 == 1) ? brightness : brightness << 4;
+	for (uint32_t i = y0; i <= y1; i++)
+	{
+		*byte = (*byte & mask) | value;
+		byte += canvas->stride;
+	}
+}
 
-void set_buffer_size(uint16_t buffer_width, uint16_t buffer_height)
+//====================== put horizontal line ========================//
+/**
+ *  @brief Writes horizontal line at frame buffer coordinates, ignoring rotation.
+ *
+ *  Whole bytes in the middle of the line are filled at once, only odd ends are written
+ *  nibble by nibble.
+ */
+static void put_hline(GFXcanvas *canvas, uint16_t y, uint16_t x0, uint16_t x1, uint8_t brightness)
 {
-	_buffer_width = buffer_width;
-	_buffer_height = buffer_height;
+	if (x0 > x1)
+	{
+		uint16_t tmp = x0;
+		x0 = x1;
+		x1 = tmp;
+	}
+	if (y < canvas->clip.y0 || y > canvas->clip.y1 || x1 < canvas->clip.x0 || x0 > canvas->clip.x1)
+		return;
+	if (x0 < canvas->clip.x0)
+		x0 = canvas->clip.x0;
+	if (x1 > canvas->clip.x1)
+		x1 = canvas->clip.x1;
+
+	uint8_t *row = canvas->buffer + (uint32_t)y * canvas->stride;
+	if (x0 % 2 == 1)
+	{
+		row[x0 / 2] = (row[x0 / 2] & 0xF0) | brightness;
+		x0++;
+	}
+	if (x1 % 2 == 0 && x1 >= x0)
+	{
+		row[x1 / 2] = (row[x1 / 2] & 0x0F) | (brightness << 4);
+		if (x1 == 0)
+			return;
+		x1--;
+	}
+	if (x1 > x0)
+		memset(row + x0 / 2, (brightness << 4) | brightness, (x1 - x0 + 1) / 2);
 }
 
 //====================== fill buffer ========================//
 /**
  *  @brief Fill buffer with specified brightness
  *
- *  @param[in] frame_buffer
- *             array of pixel values
+ *  Only area inside clipping rectangle is filled, by default it is the whole canvas.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
  *  @param[in] brightness
  *             brightness value of pixel (range 0-15 dec or 0x00-0x0F hex)
  */
-void fill_buffer(uint8_t *frame_buffer, uint8_t brightness)
+void fill_buffer(GFXcanvas *canvas, uint8_t brightness)
 {
-	uint8_t byte_value = (brightness << 4) | brightness;
-	uint32_t buffer_size = _buffer_height * _buffer_width / 2;
-	while (buffer_size--)
+	const GFXrect *clip = &canvas->clip;
+
+	if (clip->x0 == 0 && clip->y0 == 0 && clip->x1 == canvas->width - 1 && clip->y1 == canvas->height - 1
+			&& canvas->stride == canvas->width / 2)
+	{
+		memset(canvas->buffer, (brightness << 4) | brightness, (uint32_t)canvas->height * canvas->stride);
+		return;
+	}
+	for (uint16_t y = clip->y0; y <= clip->y1; y++)
 	{
-		*frame_buffer++ = byte_value;
+		put_hline(canvas, y, clip->x0, clip->x1, brightness);
 	}
 }
 
@@ -74,8 +359,8 @@ void fill_buffer(uint8_t *frame_buffer, uint8_t brightness)
  *  Pixels drawn outside buffer outline are ignored to avoid overwriting
  *  memory outside frame buffer - "segfault".
  *
- *  @param[in] frame_buffer
- *             array of pixel values
+ *  @param[in] canvas
+ *             canvas to draw on
  *  @param[in] x
  *             horizontal coordinate of pixel
  *  @param[in] y
@@ -83,19 +368,35 @@ void fill_buffer(uint8_t *frame_buffer, uint8_t brightness)
  *  @param[in] brightness
  *             brightness value of pixel (range 0-15 dec or 0x00-0x0F hex)
  */
-void draw_pixel(uint8_t *frame_buffer, uint16_t x, uint16_t y, uint8_t brightness)
+void draw_pixel(GFXcanvas *canvas, uint16_t x, uint16_t y, uint8_t brightness)
 {
-	if(x > (_buffer_width-1) || y > (_buffer_height-1))
-		return;
+	rotate_point(canvas, &x, &y);
+	put_pixel(canvas, x, y, brightness);
+}
 
-	if ((y * _buffer_width + x) % 2 == 1)
-	{
-		frame_buffer[((y * _buffer_width) + x) / 2] = (frame_buffer[((y * _buffer_width) + x) / 2] & 0xF0) | brightness;
-	}
-	else
-	{
-		frame_buffer[((y * _buffer_width) + x) / 2] = (frame_buffer[((y * _buffer_width) + x) / 2] & 0x0F) | (brightness << 4);
-	}
+//====================== read pixel ========================//
+/**
+ *  @brief Reads brightness of one pixel
+ *
+ *  Used by drawing functions that blend with what is already drawn, e.g. antialiased curves.
+ *
+ *  @param[in] canvas
+ *             canvas to read from
+ *  @param[in] x
+ *             horizontal coordinate of pixel
+ *  @param[in] y
+ *             vertical coordinate of pixel
+ *
+ *  @return brightness of pixel (0-15), 0 for pixels outside canvas
+ */
+uint8_t get_pixel(const GFXcanvas *canvas, uint16_t x, uint16_t y)
+{
+	rotate_point(canvas, &x, &y);
+	if (x >= canvas->width || y >= canvas->height)
+		return 0;
+
+	uint8_t byte = canvas->buffer[(uint32_t)y * canvas->stride + x / 2];
+	return (x % 2 == 1) ? byte & 0x0F : byte >> 4;
 }
 
 //====================== draw vertical line ========================//
@@ -104,8 +405,8 @@ void draw_pixel(uint8_t *frame_buffer, uint16_t x, uint16_t y, uint8_t brightnes
  *
  *  Draws vertical line of specified brightness on given coordinates on frame buffer.
  *
- *  @param[in] frame_buffer
- *             array of pixel values
+ *  @param[in] canvas
+ *             canvas to draw on
  *  @param[in] x
  *             horizontal coordinate of line
  *  @param[in] y0
@@ -115,22 +416,22 @@ void draw_pixel(uint8_t *frame_buffer, uint16_t x, uint16_t y, uint8_t brightnes
  * 	@param[in] brightness
  *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
  */
-void draw_vline(uint8_t *frame_buffer, uint16_t x, uint16_t y0, uint16_t y1, uint8_t brightness)
+void draw_vline(GFXcanvas *canvas, uint16_t x, uint16_t y0, uint16_t y1, uint8_t brightness)
 {
-	if(y0 < y1)
-	{
-		for (uint16_t i = y0; i <= y1; i++)
-		{
-			draw_pixel(frame_buffer, x, i, brightness);
-		}
-	}
+	uint16_t draw_width = (canvas->rotation & 1) ? canvas->height : canvas->width;
+	uint16_t draw_height = (canvas->rotation & 1) ? canvas->width : canvas->height;
+
+	if (x >= draw_width || !clip_span(draw_height, &y0, &y1))
+		return;
+
+	uint16_t x1 = x;
+	rotate_point(canvas, &x, &y0);
+	rotate_point(canvas, &x1, &y1);
+
+	if (x == x1)
+		put_vline(canvas, x, y0, y1, brightness);
 	else
-	{
-		for (uint16_t i = y1; i <= y0; i++)
-		{
-			draw_pixel(frame_buffer, x, i, brightness);
-		}
-	}
+		put_hline(canvas, y0, x, x1, brightness);
 }
 
 //====================== draw horizontal line ========================//
@@ -139,8 +440,8 @@ void draw_vline(uint8_t *frame_buffer, uint16_t x, uint16_t y0, uint16_t y1, uin
  *
  *  Draws horizontal line of specified brightness on given coordinates on frame buffer.
  *
- *  @param[in] frame_buffer
- *             array of pixel values
+ *  @param[in] canvas
+ *             canvas to draw on
  *  @param[in] y
  *             vertical coordinate of line
  *  @param[in] x0
@@ -150,22 +451,22 @@ void draw_vline(uint8_t *frame_buffer, uint16_t x, uint16_t y0, uint16_t y1, uin
  * 	@param[in] brightness
  *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
  */
-void draw_hline(uint8_t *frame_buffer, uint16_t y, uint16_t x0, uint16_t x1, uint8_t brightness)
+void draw_hline(GFXcanvas *canvas, uint16_t y, uint16_t x0, uint16_t x1, uint8_t brightness)
 {
-	if(x0 < x1)
-	{
-		for (uint16_t i = x0; i <= x1; i++)
-		{
-			draw_pixel(frame_buffer, i, y, brightness);
-		}
-	}
+	uint16_t draw_width = (canvas->rotation & 1) ? canvas->height : canvas->width;
+	uint16_t draw_height = (canvas->rotation & 1) ? canvas->width : canvas->height;
+
+	if (y >= draw_height || !clip_span(draw_width, &x0, &x1))
+		return;
+
+	uint16_t y1 = y;
+	rotate_point(canvas, &x0, &y);
+	rotate_point(canvas, &x1, &y1);
+
+	if (y == y1)
+		put_hline(canvas, y, x0, x1, brightness);
 	else
-	{
-		for (uint16_t i = x1; i <= x0; i++)
-		{
-			draw_pixel(frame_buffer, i, y, brightness);
-		}
-	}
+		put_vline(canvas, x0, y, y1, brightness);
 }
 
 //====================== draw sloping line ========================//
@@ -174,8 +475,8 @@ void draw_hline(uint8_t *frame_buffer, uint16_t y, uint16_t x0, uint16_t x1, uin
  *
  *  Can be also used to draw vertical and horizontal lines.
  *
- *  @param[in] frame_buffer
- *             array of pixel values
+ *  @param[in] canvas
+ *             canvas to draw on
  *  @param[in] x0
  *             x position of line beginning
  *  @param[in] y0
@@ -187,47 +488,54 @@ void draw_hline(uint8_t *frame_buffer, uint16_t y, uint16_t x0, uint16_t x1, uin
  * 	@param[in] brightness
  *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
 */
-void draw_line(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness)
+void draw_line(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness)
 {
 	//handle horizontal and vertical lines with appropriate functions
 	if (x0 == x1)
 	{
-		draw_vline(frame_buffer, x0, y0, y1, brightness);
+		draw_vline(canvas, x0, y0, y1, brightness);
+		return;
 	}
 	if (y0 == y1)
 	{
-		draw_hline(frame_buffer, y0, x0, x1, brightness);
+		draw_hline(canvas, y0, x0, x1, brightness);
+		return;
 	}
 
-	int16_t steep = abs(y1 - y0) > abs(x1 - x0);
-	if (steep == 1)
+	//ends beyond the canvas must not wrap around, pixels outside are skipped by put_pixel_signed()
+	int32_t px0 = x0, py0 = y0, px1 = x1, py1 = y1;
+	rotate_point_signed(canvas, &px0, &py0);
+	rotate_point_signed(canvas, &px1, &py1);
+
+	uint8_t steep = labs(py1 - py0) > labs(px1 - px0);
+	if (steep)
 	{
-		uint16_t tmp = y0;
-		y0 = x0;
-		x0 = tmp;
-		tmp = y1;
-		y1 = x1;
-		x1 = tmp;
+		int32_t tmp = py0;
+		py0 = px0;
+		px0 = tmp;
+		tmp = py1;
+		py1 = px1;
+		px1 = tmp;
 	}
 
-	if (x0 > x1)
+	if (px0 > px1)
 	{
-		uint16_t tmp = x0;
-		x0 = x1;
-		x1 = tmp;
-		tmp = y0;
-		y0 = y1;
-		y1 = tmp;
+		int32_t tmp = px0;
+		px0 = px1;
+		px1 = tmp;
+		tmp = py0;
+		py0 = py1;
+		py1 = tmp;
 	}
 
-	int16_t dx, dy;
-	dx = x1 - x0;
-	dy = abs(y1 - y0);
+	int32_t dx, dy;
+	dx = px1 - px0;
+	dy = labs(py1 - py0);
 
-	int16_t err = dx / 2;
-	int16_t ystep;
+	int32_t err = dx / 2;
+	int32_t ystep;
 
-	if (y0 < y1)
+	if (py0 < py1)
 	{
 		ystep = 1;
 	}
@@ -236,20 +544,20 @@ void draw_line(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1, uin
 		ystep = -1;
 	}
 
-	for (; x0 <= x1; x0++)
+	for (; px0 <= px1; px0++)
 	{
 		if (steep)
 		{
-			draw_pixel(frame_buffer, y0, x0, brightness);
+			put_pixel_signed(canvas, py0, px0, brightness);
 		}
 		else
 		{
-			draw_pixel(frame_buffer, x0, y0, brightness);
+			put_pixel_signed(canvas, px0, py0, brightness);
 		}
 		err -= dy;
 		if (err < 0)
 		{
-			y0 += ystep;
+			py0 += ystep;
 			err += dx;
 		}
 	}
@@ -262,8 +570,8 @@ void draw_line(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1, uin
  *  Doesn't work for lines with brightness = 1, probably because of rounding errors.
  *  Can be also used to draw vertical and horizontal lines.
  *
- *  @param[in] frame_buffer
- *             array of pixel values
+ *  @param[in] canvas
+ *             canvas to draw on
  *  @param[in] x0
  *             x position of line beginning
  *  @param[in] y0
@@ -275,77 +583,84 @@ void draw_line(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1, uin
  * 	@param[in] brightness
  *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
 */
-void draw_AA_line(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness)
+void draw_AA_line(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness)
 {
 	//handle horizontal and vertical lines with appropriate functions
 	if (x0 == x1)
 	{
-		draw_vline(frame_buffer, x0, y0, y1, brightness);
+		draw_vline(canvas, x0, y0, y1, brightness);
+		return;
 	}
 	if (y0 == y1)
 	{
-		draw_hline(frame_buffer, y0, x0, x1, brightness);
+		draw_hline(canvas, y0, x0, x1, brightness);
+		return;
 	}
 
-	uint8_t steep = abs(y1 - y0) > abs(x1 - x0);
+	//ends beyond the canvas must not wrap around, pixels outside are skipped by put_pixel_signed()
+	int32_t px0 = x0, py0 = y0, px1 = x1, py1 = y1;
+	rotate_point_signed(canvas, &px0, &py0);
+	rotate_point_signed(canvas, &px1, &py1);
+
+	uint8_t steep = labs(py1 - py0) > labs(px1 - px0);
 
 	if (steep)
 	{
-		uint16_t tmp = y0;
-		y0 = x0;
-		x0 = tmp;
-		tmp = y1;
-		y1 = x1;
-		x1 = tmp;
+		int32_t tmp = py0;
+		py0 = px0;
+		px0 = tmp;
+		tmp = py1;
+		py1 = px1;
+		px1 = tmp;
 	}
-	if (x0 > x1)
+	if (px0 > px1)
 	{
-		uint16_t tmp = x0;
-		x0 = x1;
-		x1 = tmp;
-		tmp = y0;
-		y0 = y1;
-		y1 = tmp;
+		int32_t tmp = px0;
+		px0 = px1;
+		px1 = tmp;
+		tmp = py0;
+		py0 = py1;
+		py1 = tmp;
 	}
 
-	float dx = x1 - x0;
-	float dy = y1 - y0;
+	float dx = px1 - px0;
+	float dy = py1 - py0;
 	float gradient = dy / dx;
 
 	// handle first endpoint
-	float xend = round(x0);
-	float yend = y0 + gradient * (xend - x0);
-	float xgap =  1 - ((x0 + 0.5) - floor(x0 + 0.5));
+	float xend = round(px0);
+	float yend = py0 + gradient * (xend - px0);
+	float xgap =  1 - ((px0 + 0.5) - floor(px0 + 0.5));
 	float xpxl1 = xend; // this will be used in the main loop
 	float ypxl1 = floor(yend);
 	if (steep)
 	{
-		draw_pixel(frame_buffer, ypxl1, xpxl1, (1-(yend - (floor(yend))) * xgap)*brightness);
-		draw_pixel(frame_buffer, ypxl1 + 1, xpxl1, (yend - (floor(yend)) * xgap)*brightness);
+		put_pixel_signed(canvas, ypxl1, xpxl1, (1-(yend - (floor(yend))) * xgap)*brightness);
+		put_pixel_signed(canvas, ypxl1 + 1, xpxl1, (yend - (floor(yend)) * xgap)*brightness);
 	}
 	else
 	{
-		draw_pixel(frame_buffer, xpxl1, ypxl1, (1-(yend - (floor(yend))) * xgap)*brightness);
-		draw_pixel(frame_buffer, xpxl1, ypxl1 + 1, (yend - (floor(yend)) * xgap)*brightness);
+		put_pixel_signed(canvas, xpxl1, ypxl1, (1-(yend - (floor(yend))) * xgap)*brightness);
+		put_pixel_signed(canvas, xpxl1, ypxl1 + 1, (yend - (floor(yend)) * xgap)*brightness);
 	}
 
 	float intery = yend + gradient; // first y-intersection for the main loop
 
 	// handle second endpoint
-	xend = round(x1);
-	yend = y1 + gradient * (xend - x1);
-	xgap = (x1 + 0.5) - floor(x1 + 0.5);
+	xend = round(px1);
+	yend = py1 + gradient * (xend - px1);
+	xgap = (px1 + 0.5) - floor(px1 + 0.5);
 	float xpxl2 = xend; //this will be used in the main loop
 	float ypxl2 = floor(yend);
 	if (steep)
 	{
-		draw_pixel(frame_buffer, ypxl2, xpxl2, (1 - (yend - floor(yend)) * xgap)*brightness);
-		draw_pixel(frame_buffer, ypxl2 + 1, xpxl2, ((yend - floor(yend)) * xgap)*brightness);
+		put_pixel_signed(canvas, ypxl2, xpxl2, (1 - (yend - floor(yend)) * xgap)*brightness);
+		put_pixel_signed(canvas, ypxl2 + 1, xpxl2, ((yend - floor(yend)) * xgap)*brightness);
 	}
 	else
 	{
-		draw_pixel(frame_buffer, xpxl2, ypxl2, (1 - (yend - floor(yend)) * xgap)*brightness);
-		draw_pixel(frame_buffer, xpxl2, ypxl2 + 1, ((yend - floor(yend)) * xgap)*brightness);
+		put_pixel_signed(canvas, xpxl2, ypxl2, (1 - (yend - floor(yend)) * xgap)*brightness);
+		put_pixel_signed(canvas, xpxl2, ypxl2 + 1, ((yend - floor(yend)) * xgap)*brightness);
 	}
 
 	// main loop
@@ -353,8 +668,8 @@ void draw_AA_line(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1,
 	{
 		for (int x = xpxl1 + 1; x <= xpxl2 - 1; x++)
 		{
-			draw_pixel(frame_buffer, floor(intery), x, (1 - (intery - floor(intery)))*brightness);
-			draw_pixel(frame_buffer, floor(intery) + 1, x, (intery - floor(intery))*brightness);
+			put_pixel_signed(canvas, floor(intery), x, (1 - (intery - floor(intery)))*brightness);
+			put_pixel_signed(canvas, floor(intery) + 1, x, (intery - floor(intery))*brightness);
 			intery = intery + gradient;
 		}
 	}
@@ -362,8 +677,8 @@ void draw_AA_line(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1,
 	{
 		for (int x = xpxl1 + 1; x <= xpxl2 - 1; x++)
 		{
-			draw_pixel(frame_buffer, x, floor(intery), (1 - (intery - floor(intery)))*brightness);
-			draw_pixel(frame_buffer, x, floor(intery) + 1, (intery - floor(intery))*brightness);
+			put_pixel_signed(canvas, x, floor(intery), (1 - (intery - floor(intery)))*brightness);
+			put_pixel_signed(canvas, x, floor(intery) + 1, (intery - floor(intery))*brightness);
 			intery = intery + gradient;
 		}
 	}
@@ -375,8 +690,8 @@ void draw_AA_line(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1,
 /**
  *  @brief Draws empty rectangle on frame buffer
  *
- *  @param[in] frame_buffer
- *             array of pixel values
+ *  @param[in] canvas
+ *             canvas to draw on
  *  @param[in] x0
  *             x position of first corner
  *  @param[in] y0
@@ -388,20 +703,20 @@ void draw_AA_line(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1,
  * 	@param[in] brightness
  *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
  */
-void draw_rect(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness)
+void draw_rect(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness)
 {
-	draw_vline(frame_buffer, x0, y0, y1, brightness);
-	draw_vline(frame_buffer, x1, y0, y1, brightness);
-	draw_hline(frame_buffer, y0, x0, x1, brightness);
-	draw_hline(frame_buffer, y1, x0, x1, brightness);
+	draw_vline(canvas, x0, y0, y1, brightness);
+	draw_vline(canvas, x1, y0, y1, brightness);
+	draw_hline(canvas, y0, x0, x1, brightness);
+	draw_hline(canvas, y1, x0, x1, brightness);
 }
 
 //====================== draw filled rectangle ========================//
 /**
  *  @brief Draws filled rectangle on frame buffer
  *
- *  @param[in] frame_buffer
- *             array of pixel values
+ *  @param[in] canvas
+ *             canvas to draw on
  *  @param[in] x0
  *             x position of first corner
  *  @param[in] y0
@@ -413,14 +728,32 @@ void draw_rect(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1, uin
  * 	@param[in] brightness
  *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
  */
-void draw_rect_filled(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness)
+void draw_rect_filled(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness)
 {
-	for (uint16_t i = x0; i <= x1; i++)
+	uint16_t draw_width = (canvas->rotation & 1) ? canvas->height : canvas->width;
+	uint16_t draw_height = (canvas->rotation & 1) ? canvas->width : canvas->height;
+
+	if (!clip_span(draw_width, &x0, &x1) || !clip_span(draw_height, &y0, &y1))
+		return;
+
+	rotate_point(canvas, &x0, &y0);
+	rotate_point(canvas, &x1, &y1);
+	if (x0 > x1)
 	{
-		for (uint16_t j = y0; j <= y1; j++)
-		{
-			draw_pixel(frame_buffer, i, j, brightness);
-		}
+		uint16_t tmp = x0;
+		x0 = x1;
+		x1 = tmp;
+	}
+	if (y0 > y1)
+	{
+		uint16_t tmp = y0;
+		y0 = y1;
+		y1 = tmp;
+	}
+
+	for (uint32_t j = y0; j <= y1; j++)
+	{
+		put_hline(canvas, j, x0, x1, brightness);
 	}
 }
 
@@ -428,8 +761,8 @@ void draw_rect_filled(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t
 /**
  *  @brief Draws empty circle on frame buffer
  *
- *  @param[in] frame_buffer
- *             array of pixel values
+ *  @param[in] canvas
+ *             canvas to draw on
  *  @param[in] x0
  *             x position of circle's center
  *  @param[in] y0
@@ -439,7 +772,7 @@ void draw_rect_filled(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t
  * 	@param[in] brightness
  *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
  */
-void draw_circle(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t r, uint8_t brightness)
+void draw_circle(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t r, uint8_t brightness)
 {
   int16_t f = 1 - r;
   int16_t ddF_x = 1;
@@ -447,10 +780,12 @@ void draw_circle(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t r, ui
   int16_t x = 0;
   int16_t y = r;
 
-  draw_pixel(frame_buffer, x0, y0 + r, brightness);
-  draw_pixel(frame_buffer, x0, y0 - r, brightness);
-  draw_pixel(frame_buffer, x0 + r, y0, brightness);
-  draw_pixel(frame_buffer, x0 - r, y0, brightness);
+  rotate_point(canvas, &x0, &y0);
+
+  put_pixel(canvas, x0, y0 + r, brightness);
+  put_pixel(canvas, x0, y0 - r, brightness);
+  put_pixel(canvas, x0 + r, y0, brightness);
+  put_pixel(canvas, x0 - r, y0, brightness);
 
   while (x < y)
   {
@@ -464,14 +799,14 @@ void draw_circle(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t r, ui
     ddF_x += 2;
     f += ddF_x;
 
-    draw_pixel(frame_buffer, x0 + x, y0 + y, brightness);
-    draw_pixel(frame_buffer, x0 - x, y0 + y, brightness);
-    draw_pixel(frame_buffer, x0 + x, y0 - y, brightness);
-    draw_pixel(frame_buffer, x0 - x, y0 - y, brightness);
-    draw_pixel(frame_buffer, x0 + y, y0 + x, brightness);
-    draw_pixel(frame_buffer, x0 - y, y0 + x, brightness);
-    draw_pixel(frame_buffer, x0 + y, y0 - x, brightness);
-    draw_pixel(frame_buffer, x0 - y, y0 - x, brightness);
+    put_pixel(canvas, x0 + x, y0 + y, brightness);
+    put_pixel(canvas, x0 - x, y0 + y, brightness);
+    put_pixel(canvas, x0 + x, y0 - y, brightness);
+    put_pixel(canvas, x0 - x, y0 - y, brightness);
+    put_pixel(canvas, x0 + y, y0 + x, brightness);
+    put_pixel(canvas, x0 - y, y0 + x, brightness);
+    put_pixel(canvas, x0 + y, y0 - x, brightness);
+    put_pixel(canvas, x0 - y, y0 - x, brightness);
   }
 }
 
@@ -484,8 +819,8 @@ void draw_circle(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t r, ui
  *
  *  You can use any image to bitmap converter as long as it gives you an 8-bit grayscale color depth array.
  *
- *  @param[in] frame_buffer
- *             array of pixel values
+ *  @param[in] canvas
+ *             canvas to draw on
  *  @param[in] bitmap
  *  		   array with pixels to write to frame buffer
  *  @param[in] x0
@@ -497,18 +832,102 @@ void draw_circle(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t r, ui
  *  @param[in] y_size
  *             height of bitmap in pixels
  */
-void draw_bitmap_8bpp(uint8_t *frame_buffer, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size)
+void draw_bitmap_8bpp(GFXcanvas *canvas, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size)
 {
-	uint16_t bitmap_pos = 0;
+	uint32_t bitmap_pos = 0;
+	int8_t x_dx, x_dy, y_dx, y_dy;
+
+	rotate_point(canvas, &x0, &y0);
+	rotation_steps(canvas, &x_dx, &x_dy, &y_dx, &y_dy);
 
-	for (uint16_t i = y0; i < y0 + y_size; i++)
+	for (uint16_t i = 0; i < y_size; i++)
 	{
-		for (uint16_t j = x0; j < x0 + x_size; j++)
+		uint16_t x = x0 + i * y_dx;
+		uint16_t y = y0 + i * y_dy;
+		for (uint16_t j = 0; j < x_size; j++)
 		{
-			draw_pixel(frame_buffer, j, i, bitmap[bitmap_pos] >> 4);
+			put_pixel(canvas, x, y, bitmap[bitmap_pos] >> 4);
 			bitmap_pos++;
+			x += x_dx;
+			y += x_dy;
+		}
+	}
+}
+
+//====================== put 4-bit bitmap rows ========================//
+/**
+ *  @brief Draws selected rows of 4 bits per pixel bitmap, pixel by pixel.
+ */
+static void put_bitmap_4bpp_rows(GFXcanvas *canvas, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t first_row, uint16_t end_row)
+{
+	uint32_t processed_pixels = (uint32_t)first_row * x_size;
+	int8_t x_dx, x_dy, y_dx, y_dy;
+
+	rotate_point(canvas, &x0, &y0);
+	rotation_steps(canvas, &x_dx, &x_dy, &y_dx, &y_dy);
+
+	for (uint16_t i = first_row; i < end_row; i++)
+	{
+		uint16_t x = x0 + i * y_dx;
+		uint16_t y = y0 + i * y_dy;
+		for (uint16_t j = 0; j < x_size; j++)
+		{
+			uint8_t byte = bitmap[processed_pixels / 2];
+			put_pixel(canvas, x, y, (processed_pixels % 2 == 0) ? byte >> 4 : byte & 0x0F);
+			processed_pixels++;
+			x += x_dx;
+			y += x_dy;
+		}
+	}
+}
+
+//====================== put transposed 4-bit bitmap ========================//
+/**
+ *  @brief Draws 4 bits per pixel bitmap rotated by 90 or 270 degrees, two rows at a time.
+ *
+ *  Bitmap rows become frame buffer columns. Every 2x2 block of pixels is read as two bitmap
+ *  bytes and written as two frame buffer bytes with nibbles swapped between them, so no pixel
+ *  is written separately. Bitmap has to fit in clipping rectangle, have even width and first_row
+ *  has to land on even frame buffer x.
+ *
+ *  @return amount of processed rows (always even)
+ */
+static uint16_t put_bitmap_4bpp_transposed(GFXcanvas *canvas, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size, uint16_t first_row)
+{
+	uint16_t row_bytes = x_size / 2;
+	int32_t stride = canvas->stride;
+	uint16_t i;
+
+	for (i = first_row; i + 1 < y_size; i += 2)
+	{
+		const uint8_t *a = bitmap + (uint32_t)i * row_bytes;
+		const uint8_t *b = a + row_bytes;
+		uint8_t *dst;
+
+		if (canvas->rotation == GFX_ROTATION_90)
+		{
+			//bitmap row i + 1 lands in high nibble, column j goes to frame buffer row x0 + j
+			dst = canvas->buffer + x0 * stride + (canvas->width - 2 - y0 - i) / 2;
+			for (uint16_t j = 0; j < row_bytes; j++)
+			{
+				dst[0] = (b[j] & 0xF0) | (a[j] >> 4);
+				dst[stride] = (b[j] << 4) | (a[j] & 0x0F);
+				dst += 2 * stride;
+			}
+		}
+		else
+		{
+			//bitmap row i lands in high nibble, column j goes to frame buffer row height - 1 - x0 - j
+			dst = canvas->buffer + (canvas->height - 1 - x0) * stride + (y0 + i) / 2;
+			for (uint16_t j = 0; j < row_bytes; j++)
+			{
+				dst[0] = (a[j] & 0xF0) | (b[j] >> 4);
+				dst[-stride] = (a[j] << 4) | (b[j] & 0x0F);
+				dst -= 2 * stride;
+			}
 		}
 	}
+	return i - first_row;
 }
 
 //====================== draw 4-bit bitmap ========================//
@@ -519,8 +938,8 @@ void draw_bitmap_8bpp(uint8_t *frame_buffer, const uint8_t *bitmap, uint16_t x0,
  *
  * 	WARNING: This function is still untested!
  *
- *  @param[in] frame_buffer
- *             array of pixel values
+ *  @param[in] canvas
+ *             canvas to draw on
  *  @param[in] bitmap
  *  		   array with pixels to write to frame buffer
  *  @param[in] x0
@@ -532,75 +951,720 @@ void draw_bitmap_8bpp(uint8_t *frame_buffer, const uint8_t *bitmap, uint16_t x0,
  *  @param[in] y_size
  *             height of bitmap in pixels
  */
-void draw_bitmap_4bpp(uint8_t *frame_buffer, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size)
+void draw_bitmap_4bpp(GFXcanvas *canvas, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size)
 {
-	uint16_t bitmap_pos = 0;       //byte index in bitmap array
-	uint16_t processed_pixels = 0;
-	uint8_t pixel_parity = 0;      //if pixel is even = 0; odd = 1
+	uint16_t first_row = 0;
+	uint16_t ax = x0, ay = y0, bx = x0 + x_size - 1, by = y0 + y_size - 1;
+
+	rotate_point(canvas, &ax, &ay);
+	rotate_point(canvas, &bx, &by);
 
-	for (uint16_t i = y0; i < y0 + y_size; i++)
+	//portrait rotations of bitmaps with whole bytes per row use transposing kernel
+	if ((canvas->rotation == GFX_ROTATION_90 || canvas->rotation == GFX_ROTATION_270) && x_size % 2 == 0 && y_size > 0
+			&& x0 + x_size <= canvas->height && y0 + y_size <= canvas->width
+			&& (ax < bx ? ax : bx) >= canvas->clip.x0 && (ax < bx ? bx : ax) <= canvas->clip.x1
+			&& (ay < by ? ay : by) >= canvas->clip.y0 && (ay < by ? by : ay) <= canvas->clip.y1)
 	{
-		for (uint16_t j = x0; j < x0 + x_size; j++)
+		//kernel needs pairs of bitmap rows that land in one frame buffer byte
+		if ((y0 % 2 == 1) && y_size > 0)
 		{
-			pixel_parity = processed_pixels % 2;
-
-			if(pixel_parity == 0)
-			{
-				draw_pixel(frame_buffer, j, i, bitmap[bitmap_pos] >> 4);
-				processed_pixels++;
-			}
-			else
-			{
-				draw_pixel(frame_buffer, j, i, bitmap[bitmap_pos]);
-				processed_pixels++;
-				bitmap_pos++;
-			}
+			put_bitmap_4bpp_rows(canvas, bitmap, x0, y0, x_size, 0, 1);
+			first_row = 1;
 		}
+		first_row += put_bitmap_4bpp_transposed(canvas, bitmap, x0, y0, x_size, y_size, first_row);
 	}
-}
 
-//====================== select font ========================//
-/**
- *  @brief Select font to write text
- *
- *  This function has to be called at least once to define font.
- *  Next call is needed only when you want to change font to other one.
- *
- *  @param[in] new_gfx_font
- *             pointer to font structure
- */
-void select_font(const GFXfont *new_gfx_font)
-{
-	gfx_font = new_gfx_font;
+	if (first_row < y_size)
+		put_bitmap_4bpp_rows(canvas, bitmap, x0, y0, x_size, first_row, y_size);
 }
 
-//====================== draw single character ========================//
+//====================== 1-bit expansion masks ========================//
+// Four bitmap bits (first pixel in highest bit) expanded to four frame buffer nibbles
+static const uint16_t nibble_masks[16] = {
+	0x0000, 0x000F, 0x00F0, 0x00FF, 0x0F00, 0x0F0F, 0x0FF0, 0x0FFF,
+	0xF000, 0xF00F, 0xF0F0, 0xF0FF, 0xFF00, 0xFF0F, 0xFFF0, 0xFFFF
+};
+
+//====================== put 1-bit bitmap ========================//
 /**
- *  @brief Draw single character
- *
- *	To draw character font has to be selected.
+ *  @brief Draws 1 bit per pixel bitmap with expansion table.
  *
- *  @param[in] frame_buffer
- *             array of pixel values
- *  @param[in] c
- *             ASCII character to draw in buffer
- *  @param[in] x
- *             x position of bottom left corner of character
- *  @param[in] y
- *             y position of bottom left corner of character
- * 	@param[in] brightness
- *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
+ *  values[n] are four pixels (two frame buffer bytes) of source nibble n. If bitmap is not rotated
+ *  and fits in clipping rectangle, every 4 bitmap bits are written as two bytes at once (three
+ *  bytes with kept outer nibbles at odd x). Remaining pixels are drawn one by one.
  */
-void draw_char(uint8_t *frame_buffer, uint8_t c, uint16_t x, uint16_t y, uint8_t brightness)
+static void put_bitmap_1bpp(GFXcanvas *canvas, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size,
+		const uint16_t *values, uint8_t opaque, uint8_t foreground, uint8_t background)
 {
-	if(gfx_font == NULL)
+	uint16_t row_bytes = (x_size + 7) / 8;
+	uint16_t first_column = 0;
+	int8_t x_dx, x_dy, y_dx, y_dy;
+
+	if (x_size == 0 || y_size == 0)
 		return;
 
-	c -= (uint8_t)gfx_font->first;          //convert input char to corresponding byte from font array
-    GFXglyph *glyph = gfx_font->glyph + c;  //get pointer of glyph corresponding to char
-    uint8_t *bitmap = gfx_font->bitmap;     //get pointer of char bitmap
+	if (canvas->rotation == GFX_ROTATION_0 && x0 >= canvas->clip.x0 && (uint32_t)x0 + x_size - 1 <= canvas->clip.x1
+			&& y0 >= canvas->clip.y0 && (uint32_t)y0 + y_size - 1 <= canvas->clip.y1)
+	{
+		uint16_t chunks = x_size / 4;
 
-    uint16_t bo = glyph->bitmapOffset;
+		for (uint16_t i = 0; i < y_size; i++)
+		{
+			const uint8_t *src = bitmap + (uint32_t)i * row_bytes;
+			uint8_t *dst = canvas->buffer + (uint32_t)(y0 + i) * canvas->stride + x0 / 2;
+
+			//most common case - whole bitmap bytes written as four frame buffer bytes
+			uint16_t c = 0;
+			if (x0 % 2 == 0 && opaque)
+			{
+				for (; c + 1 < chunks; c += 2)
+				{
+					uint16_t high = values[src[c / 2] >> 4];
+					uint16_t low = values[src[c / 2] & 0x0F];
+					dst[0] = high >> 8;
+					dst[1] = high & 0xFF;
+					dst[2] = low >> 8;
+					dst[3] = low & 0xFF;
+					dst += 4;
+				}
+			}
+
+			for (; c < chunks; c++)
+			{
+				uint8_t bits = (c % 2 == 0) ? src[c / 2] >> 4 : src[c / 2] & 0x0F;
+				uint16_t value = values[bits];
+				uint16_t mask = opaque ? 0xFFFF : nibble_masks[bits];
+
+				if (x0 % 2 == 0)
+				{
+					dst[0] = (dst[0] & ~(mask >> 8)) | (value >> 8);
+					dst[1] = (dst[1] & ~mask) | (value & 0xFF);
+				}
+				else
+				{
+					//four nibbles shifted by one - low nibble of first byte, second byte, high nibble of third byte
+					dst[0] = (dst[0] & ~(mask >> 12)) | (value >> 12);
+					dst[1] = (dst[1] & ~(mask >> 4)) | ((value >> 4) & 0xFF);
+					dst[2] = (dst[2] & ~((mask & 0x0F) << 4)) | ((value & 0x0F) << 4);
+				}
+				dst += 2;
+			}
+		}
+		first_column = chunks * 4;
+		if (first_column == x_size)
+			return;
+	}
+
+	//rotated, clipped or last pixels of rows
+	rotate_point(canvas, &x0, &y0);
+	rotation_steps(canvas, &x_dx, &x_dy, &y_dx, &y_dy);
+
+	for (uint16_t i = 0; i < y_size; i++)
+	{
+		const uint8_t *src = bitmap + (uint32_t)i * row_bytes;
+		uint16_t x = x0 + i * y_dx + first_column * x_dx;
+		uint16_t y = y0 + i * y_dy + first_column * x_dy;
+		for (uint16_t j = first_column; j < x_size; j++)
+		{
+			if (src[j / 8] & (0x80 >> (j % 8)))
+				put_pixel(canvas, x, y, foreground);
+			else if (opaque)
+				put_pixel(canvas, x, y, background);
+			x += x_dx;
+			y += x_dy;
+		}
+	}
+}
+
+//====================== draw 1-bit bitmap ========================//
+/**
+ *  @brief Draws 1 bit per pixel bitmap with selected brightness of set and cleared bits.
+ *
+ *  Every row starts at new byte, first pixel is the highest bit (the same format as bitmaps
+ *  of Adafruit GFX library). 16-entry table with both brightness values is built once, so
+ *  4 pixels are written at a time.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] bitmap
+ *  		   array with pixels, (x_size + 7) / 8 bytes per row
+ *  @param[in] x0
+ *             x position of top left bitmap corner
+ *  @param[in] y0
+ *             y position of top left bitmap corner
+ *  @param[in] x_size
+ *             width of bitmap in pixels
+ *  @param[in] y_size
+ *             height of bitmap in pixels
+ * 	@param[in] foreground
+ *             brightness of set bits (range 0-15 dec or 0x00-0x0F hex)
+ * 	@param[in] background
+ *             brightness of cleared bits (range 0-15 dec or 0x00-0x0F hex)
+ */
+void draw_bitmap_1bpp(GFXcanvas *canvas, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size,
+		uint8_t foreground, uint8_t background)
+{
+	uint16_t values[16];
+	uint16_t foreground_nibbles = foreground * 0x1111;
+	uint16_t background_nibbles = background * 0x1111;
+
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		values[i] = (foreground_nibbles & nibble_masks[i]) | (background_nibbles & ~nibble_masks[i]);
+	}
+	put_bitmap_1bpp(canvas, bitmap, x0, y0, x_size, y_size, values, 1, foreground, background);
+}
+
+//====================== draw transparent 1-bit bitmap ========================//
+/**
+ *  @brief Draws set bits of 1 bit per pixel bitmap, cleared bits leave frame buffer unchanged.
+ *
+ *  Bitmap format is the same as in draw_bitmap_1bpp().
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] bitmap
+ *  		   array with pixels, (x_size + 7) / 8 bytes per row
+ *  @param[in] x0
+ *             x position of top left bitmap corner
+ *  @param[in] y0
+ *             y position of top left bitmap corner
+ *  @param[in] x_size
+ *             width of bitmap in pixels
+ *  @param[in] y_size
+ *             height of bitmap in pixels
+ * 	@param[in] brightness
+ *             brightness of set bits (range 0-15 dec or 0x00-0x0F hex)
+ */
+void draw_bitmap_1bpp_transparent(GFXcanvas *canvas, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size,
+		uint8_t brightness)
+{
+	uint16_t values[16];
+	uint16_t nibbles = brightness * 0x1111;
+
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		values[i] = nibbles & nibble_masks[i];
+	}
+	put_bitmap_1bpp(canvas, bitmap, x0, y0, x_size, y_size, values, 0, brightness, 0);
+}
+
+//====================== bitmap pixel value ========================//
+/**
+ *  @brief Reads pixel of 4 or 8 bits per pixel bitmap as 8-bit brightness.
+ */
+static uint8_t bitmap_value(const uint8_t *bitmap, uint8_t bpp, uint16_t x_size, uint16_t x, uint16_t y)
+{
+	uint32_t pos = (uint32_t)y * x_size + x;
+
+	if (bpp == 8)
+		return bitmap[pos];
+
+	uint8_t byte = bitmap[pos / 2];
+	return ((pos % 2 == 0) ? byte >> 4 : byte & 0x0F) * 17;
+}
+
+//====================== scaled bitmap sample ========================//
+/**
+ *  @brief Samples bitmap at 16.16 fixed point position and returns 4-bit brightness.
+ */
+static uint8_t scaled_sample(const uint8_t *bitmap, uint8_t bpp, uint16_t x_size, uint16_t y_size, int32_t fx, int32_t fy, uint8_t filter)
+{
+	if (fx < 0)
+		fx = 0;
+	if (fy < 0)
+		fy = 0;
+
+	uint16_t sx = fx >> 16;
+	uint16_t sy = fy >> 16;
+	if (sx > x_size - 1)
+		sx = x_size - 1;
+	if (sy > y_size - 1)
+		sy = y_size - 1;
+
+	if (filter == GFX_SCALE_NEAREST)
+		return bitmap_value(bitmap, bpp, x_size, sx, sy) >> 4;
+
+	uint16_t sx1 = (sx + 1 < x_size) ? sx + 1 : sx;
+	uint16_t sy1 = (sy + 1 < y_size) ? sy + 1 : sy;
+	int32_t ax = (fx >> 8) & 0xFF;
+	int32_t ay = (fy >> 8) & 0xFF;
+
+	int32_t p00 = bitmap_value(bitmap, bpp, x_size, sx, sy);
+	int32_t p01 = bitmap_value(bitmap, bpp, x_size, sx1, sy);
+	int32_t p10 = bitmap_value(bitmap, bpp, x_size, sx, sy1);
+	int32_t p11 = bitmap_value(bitmap, bpp, x_size, sx1, sy1);
+
+	int32_t top = p00 * 256 + (p01 - p00) * ax;
+	int32_t bottom = p10 * 256 + (p11 - p10) * ax;
+	return (top * 256 + (bottom - top) * ay) >> 20;
+}
+
+//====================== draw scaled bitmap ========================//
+/**
+ *  @brief Draws 4 or 8 bits per pixel bitmap scaled to any size.
+ *
+ *  Source position is stepped in 16.16 fixed point, so no division or floating point
+ *  is used per pixel. Nearest filter is faster and keeps sharp edges, bilinear filter
+ *  gives smooth result for photos and zoomed in icons. Pixels outside clipping rectangle are skipped
+ *  and, without rotation, pixels are written to frame buffer two at a time as whole bytes.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] bitmap
+ *  		   array with pixels, format as for draw_bitmap_8bpp() or draw_bitmap_4bpp()
+ *  @param[in] bpp
+ *  		   bits per pixel of bitmap - 4 or 8
+ *  @param[in] x_size
+ *             width of bitmap in pixels
+ *  @param[in] y_size
+ *             height of bitmap in pixels
+ *  @param[in] x0
+ *             x position of top left corner of drawn bitmap
+ *  @param[in] y0
+ *             y position of top left corner of drawn bitmap
+ *  @param[in] dst_x_size
+ *             width of drawn bitmap in pixels
+ *  @param[in] dst_y_size
+ *             height of drawn bitmap in pixels
+ *  @param[in] filter
+ *             GFX_SCALE_NEAREST or GFX_SCALE_BILINEAR
+ */
+void draw_bitmap_scaled(GFXcanvas *canvas, const uint8_t *bitmap, uint8_t bpp, uint16_t x_size, uint16_t y_size,
+		uint16_t x0, uint16_t y0, uint16_t dst_x_size, uint16_t dst_y_size, uint8_t filter)
+{
+	if (x_size == 0 || y_size == 0 || dst_x_size == 0 || dst_y_size == 0)
+		return;
+
+	int32_t step_x = ((uint32_t)x_size << 16) / dst_x_size;
+	int32_t step_y = ((uint32_t)y_size << 16) / dst_y_size;
+
+	//sample in the middle of destination pixel, bilinear filter measures from source pixel centers
+	int32_t start_x = step_x / 2;
+	int32_t start_y = step_y / 2;
+	if (filter == GFX_SCALE_BILINEAR)
+	{
+		start_x -= 0x8000;
+		start_y -= 0x8000;
+	}
+
+	if (canvas->rotation != GFX_ROTATION_0)
+	{
+		int8_t x_dx, x_dy, y_dx, y_dy;
+		rotate_point(canvas, &x0, &y0);
+		rotation_steps(canvas, &x_dx, &x_dy, &y_dx, &y_dy);
+
+		for (uint16_t i = 0; i < dst_y_size; i++)
+		{
+			int32_t fy = start_y + i * step_y;
+			int32_t fx = start_x;
+			uint16_t x = x0 + i * y_dx;
+			uint16_t y = y0 + i * y_dy;
+			for (uint16_t j = 0; j < dst_x_size; j++)
+			{
+				put_pixel(canvas, x, y, scaled_sample(bitmap, bpp, x_size, y_size, fx, fy, filter));
+				fx += step_x;
+				x += x_dx;
+				y += x_dy;
+			}
+		}
+		return;
+	}
+
+	const GFXrect *clip = &canvas->clip;
+	if (x0 > clip->x1 || y0 > clip->y1 || x0 + dst_x_size <= clip->x0 || y0 + dst_y_size <= clip->y0)
+		return;
+	uint16_t first_col = (x0 < clip->x0) ? clip->x0 - x0 : 0;
+	uint16_t first_row = (y0 < clip->y0) ? clip->y0 - y0 : 0;
+	uint16_t end_col = (x0 + dst_x_size > clip->x1 + 1) ? clip->x1 + 1 - x0 : dst_x_size;
+	uint16_t end_row = (y0 + dst_y_size > clip->y1 + 1) ? clip->y1 + 1 - y0 : dst_y_size;
+
+	for (uint16_t i = first_row; i < end_row; i++)
+	{
+		int32_t fy = start_y + i * step_y;
+		int32_t fx = start_x + first_col * step_x;
+		uint8_t *dst = canvas->buffer + (uint32_t)(y0 + i) * canvas->stride + (x0 + first_col) / 2;
+		uint16_t j = first_col;
+
+		if ((x0 + j) % 2 == 1)
+		{
+			*dst = (*dst & 0xF0) | scaled_sample(bitmap, bpp, x_size, y_size, fx, fy, filter);
+			dst++;
+			fx += step_x;
+			j++;
+		}
+		for (; j + 1 < end_col; j += 2)
+		{
+			uint8_t high = scaled_sample(bitmap, bpp, x_size, y_size, fx, fy, filter);
+			uint8_t low = scaled_sample(bitmap, bpp, x_size, y_size, fx + step_x, fy, filter);
+			*dst++ = (high << 4) | low;
+			fx += 2 * step_x;
+		}
+		if (j < end_col)
+		{
+			*dst = (*dst & 0x0F) | (scaled_sample(bitmap, bpp, x_size, y_size, fx, fy, filter) << 4);
+		}
+	}
+}
+
+//====================== read pixel ========================//
+/**
+ *  @brief Reads pixel x of a frame buffer row.
+ */
+static inline uint8_t get_nibble(const uint8_t *row, uint16_t x)
+{
+	return (x % 2 == 1) ? row[x / 2] & 0x0F : row[x / 2] >> 4;
+}
+
+//====================== write pixel ========================//
+/**
+ *  @brief Writes pixel x of a frame buffer row, without clipping.
+ */
+static inline void set_nibble(uint8_t *row, uint16_t x, uint8_t brightness)
+{
+	if (x % 2 == 1)
+		row[x / 2] = (row[x / 2] & 0xF0) | brightness;
+	else
+		row[x / 2] = (row[x / 2] & 0x0F) | (brightness << 4);
+}
+
+//====================== move pixels ========================//
+/**
+ *  @brief Copies n pixels from pixel sx of source row to pixel dx of destination row.
+ *
+ *  Source and destination may be the same row - pixels are then copied from the side
+ *  that is not overwritten before it is read, like memmove() does. When both positions
+ *  have the same parity whole bytes are moved with memmove(), otherwise each byte
+ *  is merged from low nibble of one source byte and high nibble of the next one.
+ */
+static void move_pixels(uint8_t *dst, uint16_t dx, const uint8_t *src, uint16_t sx, uint16_t n)
+{
+	if (n == 0)
+		return;
+
+	uint8_t backward = (dst == src && dx > sx);
+	uint8_t lead = dx % 2;              //first pixel is a low nibble
+	uint8_t trail = (dx + n) % 2;       //last pixel is a high nibble
+
+	uint16_t bytes = (n - lead - trail) / 2;
+	uint8_t *d = dst + (dx + lead) / 2;
+	const uint8_t *s = src + (sx + lead) / 2;
+	uint8_t shifted = (sx + lead) % 2;
+
+	if (!backward && lead)
+		set_nibble(dst, dx, get_nibble(src, sx));
+	if (backward && trail)
+		set_nibble(dst, dx + n - 1, get_nibble(src, sx + n - 1));
+
+	if (!shifted)
+	{
+		memmove(d, s, bytes);
+	}
+	else if (!backward)
+	{
+		for (uint16_t i = 0; i < bytes; i++)
+			d[i] = (s[i] << 4) | (s[i + 1] >> 4);
+	}
+	else
+	{
+		for (uint16_t i = bytes; i > 0; i--)
+			d[i - 1] = (s[i - 1] << 4) | (s[i] >> 4);
+	}
+
+	if (!backward && trail)
+		set_nibble(dst, dx + n - 1, get_nibble(src, sx + n - 1));
+	if (backward && lead)
+		set_nibble(dst, dx, get_nibble(src, sx));
+}
+
+//====================== scroll rectangle ========================//
+/**
+ *  @brief Moves content of a rectangle by (dx, dy) pixels, in place.
+ *
+ *  Pixels moved outside of the rectangle are lost and uncovered pixels are filled
+ *  with given brightness. Rectangle is cut to clipping rectangle. Nothing is redrawn -
+ *  existing pixels are moved row by row, so list views, terminals and graphs can
+ *  scroll without rendering their content again.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] rect
+ *             area to scroll in drawing coordinates
+ *  @param[in] dx
+ *             horizontal distance, positive moves content right
+ *  @param[in] dy
+ *             vertical distance, positive moves content down
+ * 	@param[in] brightness
+ *             brightness value of uncovered pixels (range 0-15 dec or 0x00-0x0F hex)
+ */
+void scroll_rect(GFXcanvas *canvas, const GFXrect *rect, int16_t dx, int16_t dy, uint8_t brightness)
+{
+	uint16_t x0 = rect->x0, y0 = rect->y0, x1 = rect->x1, y1 = rect->y1;
+	int8_t x_dx, x_dy, y_dx, y_dy;
+	uint16_t tmp;
+
+	rotate_point(canvas, &x0, &y0);
+	rotate_point(canvas, &x1, &y1);
+	if (x0 > x1)
+	{
+		tmp = x0;
+		x0 = x1;
+		x1 = tmp;
+	}
+	if (y0 > y1)
+	{
+		tmp = y0;
+		y0 = y1;
+		y1 = tmp;
+	}
+	if (x0 < canvas->clip.x0)
+		x0 = canvas->clip.x0;
+	if (y0 < canvas->clip.y0)
+		y0 = canvas->clip.y0;
+	if (x1 > canvas->clip.x1)
+		x1 = canvas->clip.x1;
+	if (y1 > canvas->clip.y1)
+		y1 = canvas->clip.y1;
+	if (x0 > x1 || y0 > y1)
+		return;
+
+	//direction of scrolling in frame buffer
+	rotation_steps(canvas, &x_dx, &x_dy, &y_dx, &y_dy);
+	int32_t shift_x = dx * x_dx + dy * y_dx;
+	int32_t shift_y = dx * x_dy + dy * y_dy;
+	int32_t moved = (x1 - x0 + 1) - (shift_x < 0 ? -shift_x : shift_x);
+
+	//rows are processed from the side that content moves to, so sources are read before they are overwritten
+	for (int32_t i = 0; i <= y1 - y0; i++)
+	{
+		int32_t y = shift_y > 0 ? y1 - i : y0 + i;
+		int32_t source_y = y - shift_y;
+		uint8_t *row = canvas->buffer + (uint32_t)y * canvas->stride;
+
+		if (moved <= 0 || source_y < y0 || source_y > y1)
+		{
+			put_hline(canvas, y, x0, x1, brightness);
+			continue;
+		}
+
+		const uint8_t *source = canvas->buffer + (uint32_t)source_y * canvas->stride;
+		if (shift_x >= 0)
+		{
+			move_pixels(row, x0 + shift_x, source, x0, moved);
+			if (shift_x > 0)
+				put_hline(canvas, y, x0, x0 + shift_x - 1, brightness);
+		}
+		else
+		{
+			move_pixels(row, x0, source, x0 - shift_x, moved);
+			put_hline(canvas, y, x1 + shift_x + 1, x1, brightness);
+		}
+	}
+}
+
+//====================== copy rectangle ========================//
+/**
+ *  @brief Copies rectangle of pixels from one canvas to another.
+ *
+ *  Both positions are in frame buffer coordinates - rotation of canvases is not used.
+ *  Source rectangle is cut to source canvas and destination to clipping rectangle
+ *  of destination canvas. Canvases may have different strides, or be the same canvas
+ *  with overlapping areas. Rows are copied as whole bytes when source and destination x
+ *  have the same parity, otherwise bytes are merged from neighbouring nibbles.
+ *
+ *  @param[in] dst
+ *             canvas to copy to
+ *  @param[in] x
+ *             x position of top left corner in destination
+ *  @param[in] y
+ *             y position of top left corner in destination
+ *  @param[in] src
+ *             canvas to copy from
+ *  @param[in] rect
+ *             area of source canvas to copy
+ */
+void copy_rect(GFXcanvas *dst, uint16_t x, uint16_t y, const GFXcanvas *src, const GFXrect *rect)
+{
+	int32_t sx0 = rect->x0 < rect->x1 ? rect->x0 : rect->x1;
+	int32_t sy0 = rect->y0 < rect->y1 ? rect->y0 : rect->y1;
+	int32_t sx1 = rect->x0 < rect->x1 ? rect->x1 : rect->x0;
+	int32_t sy1 = rect->y0 < rect->y1 ? rect->y1 : rect->y0;
+	int32_t dx0 = x, dy0 = y;
+
+	if (sx1 > src->width - 1)
+		sx1 = src->width - 1;
+	if (sy1 > src->height - 1)
+		sy1 = src->height - 1;
+
+	//cut destination to clipping rectangle and source by the same amount
+	if (dx0 < dst->clip.x0)
+	{
+		sx0 += dst->clip.x0 - dx0;
+		dx0 = dst->clip.x0;
+	}
+	if (dy0 < dst->clip.y0)
+	{
+		sy0 += dst->clip.y0 - dy0;
+		dy0 = dst->clip.y0;
+	}
+	if (dx0 + (sx1 - sx0) > dst->clip.x1)
+		sx1 = sx0 + dst->clip.x1 - dx0;
+	if (dy0 + (sy1 - sy0) > dst->clip.y1)
+		sy1 = sy0 + dst->clip.y1 - dy0;
+	if (sx0 > sx1 || sy0 > sy1)
+		return;
+
+	uint16_t width = sx1 - sx0 + 1;
+	uint16_t height = sy1 - sy0 + 1;
+
+	//copying down inside one buffer has to start from the bottom row
+	uint8_t bottom_up = (dst->buffer == src->buffer && dy0 > sy0);
+
+	for (uint16_t i = 0; i < height; i++)
+	{
+		uint16_t row = bottom_up ? height - 1 - i : i;
+		move_pixels(dst->buffer + (uint32_t)(dy0 + row) * dst->stride, dx0,
+				src->buffer + (uint32_t)(sy0 + row) * src->stride, sx0, width);
+	}
+}
+
+//====================== select font ========================//
+/**
+ *  @brief Select font to write text
+ *
+ *  This function has to be called at least once for each canvas to define font.
+ *  Next call is needed only when you want to change font to other one.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] new_gfx_font
+ *             pointer to font structure
+ */
+void select_font(GFXcanvas *canvas, const GFXfont *new_gfx_font)
+{
+	canvas->font = new_gfx_font;
+}
+
+//====================== decode UTF-8 character ========================//
+/**
+ *  @brief Decodes one UTF-8 encoded character.
+ *
+ *  Invalid or truncated sequences give UTF8_REPLACEMENT_CHAR. Terminating zero
+ *  is never consumed as a part of multi-byte character.
+ *
+ *  @param[in] text
+ *             pointer to first byte of a character
+ *  @param[out] length
+ *             amount of bytes taken by the character
+ *
+ *  @return Unicode codepoint
+ */
+static uint32_t utf8_decode(const char *text, uint8_t *length)
+{
+	const uint8_t *bytes = (const uint8_t *)text;
+	uint32_t codepoint;
+	uint8_t continuation;
+
+	if (bytes[0] < 0x80)
+	{
+		*length = 1;
+		return bytes[0];
+	}
+	else if ((bytes[0] & 0xE0) == 0xC0)
+	{
+		codepoint = bytes[0] & 0x1F;
+		continuation = 1;
+	}
+	else if ((bytes[0] & 0xF0) == 0xE0)
+	{
+		codepoint = bytes[0] & 0x0F;
+		continuation = 2;
+	}
+	else if ((bytes[0] & 0xF8) == 0xF0)
+	{
+		codepoint = bytes[0] & 0x07;
+		continuation = 3;
+	}
+	else
+	{
+		*length = 1;
+		return UTF8_REPLACEMENT_CHAR;
+	}
+
+	for (uint8_t i = 1; i <= continuation; i++)
+	{
+		if ((bytes[i] & 0xC0) != 0x80)
+		{
+			*length = i;
+			return UTF8_REPLACEMENT_CHAR;
+		}
+		codepoint = (codepoint << 6) | (bytes[i] & 0x3F);
+	}
+	*length = continuation + 1;
+	return codepoint;
+}
+
+//====================== font glyph count ========================//
+/**
+ *  @brief Returns amount of glyphs stored in font.
+ */
+static uint16_t font_glyph_count(const GFXfont *font)
+{
+	if (font->codepoints != NULL)
+		return font->glyph_count;
+	return font->last - font->first + 1;
+}
+
+//====================== find glyph ========================//
+/**
+ *  @brief Finds glyph of a character in font.
+ *
+ *  Contiguous fonts are indexed directly. Sparse fonts are searched in sorted
+ *  codepoint table with binary search, so lookup takes O(log n) steps.
+ *
+ *  @return pointer to glyph or NULL if character is not included in font
+ */
+static const GFXglyph *find_glyph(const GFXfont *font, uint32_t c)
+{
+	if (font == NULL || c < font->first || c > font->last)
+		return NULL;
+
+	if (font->codepoints == NULL)
+		return font->glyph + (c - font->first);
+
+	uint16_t low = 0;
+	uint16_t high = font->glyph_count;
+	while (low < high)
+	{
+		uint16_t middle = (low + high) / 2;
+		if (font->codepoints[middle] < c)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	if (low < font->glyph_count && font->codepoints[low] == c)
+		return font->glyph + low;
+	return NULL;
+}
+
+//====================== put glyph ========================//
+/**
+ *  @brief Draws glyph bitmap with its top left corner at (x + xOffset, y + yOffset).
+ */
+static void put_glyph(GFXcanvas *canvas, const GFXfont *font, const GFXglyph *glyph, uint16_t x, uint16_t y, uint8_t brightness)
+{
+    const uint8_t *bitmap = font->bitmap;  //get pointer of char bitmap
+
+    uint16_t bo = glyph->bitmapOffset;
+
+    //bitmaps of external fonts are fetched one glyph at a time
+    if (font->load_bitmap != NULL)
+    {
+        bitmap = font->load_bitmap(font->loader, glyph);
+        if (bitmap == NULL)
+            return;
+        bo = 0;
+    }
     uint8_t width = glyph->width;
     uint8_t height = glyph->height;
 
@@ -613,8 +1677,17 @@ void draw_char(uint8_t *frame_buffer, uint8_t c, uint16_t x, uint16_t y, uint8_t
     uint8_t y_pos = 0;
     uint8_t x_pos = 0;
 
+    //glyph corner is rotated once, next pixels are reached by stepping along rotated axes
+    uint16_t x0 = x + x_offset;
+    uint16_t y0 = y + y_offset;
+    int8_t x_dx, x_dy, y_dx, y_dy;
+    rotate_point(canvas, &x0, &y0);
+    rotation_steps(canvas, &x_dx, &x_dy, &y_dx, &y_dy);
+
 	for (y_pos = 0; y_pos < height; y_pos++)
 	{
+		uint16_t px = x0 + y_pos * y_dx;
+		uint16_t py = y0 + y_pos * y_dy;
 		for (x_pos = 0; x_pos < width; x_pos++)
 		{
 			if (!(bit++ & 7))
@@ -623,29 +1696,53 @@ void draw_char(uint8_t *frame_buffer, uint8_t c, uint16_t x, uint16_t y, uint8_t
 			}
 			if (bits & 0x80)
 			{
-				draw_pixel(frame_buffer, x + x_offset + x_pos, y + y_offset+y_pos, brightness);
-			}
-			else
-			{
-
+				put_pixel(canvas, px, py, brightness);
 			}
 			bits <<= 1;
+			px += x_dx;
+			py += x_dy;
 		}
 	}
 }
 
-//====================== draw string ========================//
+//====================== draw single character ========================//
 /**
  *  @brief Draw single character
  *
+ *	To draw character font has to be selected. Characters not included in font are skipped.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] c
+ *             Unicode codepoint of character to draw in buffer
+ *  @param[in] x
+ *             x position of bottom left corner of character
+ *  @param[in] y
+ *             y position of bottom left corner of character
+ * 	@param[in] brightness
+ *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
+ */
+void draw_char(GFXcanvas *canvas, uint32_t c, uint16_t x, uint16_t y, uint8_t brightness)
+{
+	const GFXglyph *glyph = find_glyph(canvas->font, c);
+	if (glyph == NULL)
+		return;
+
+	put_glyph(canvas, canvas->font, glyph, x, y, brightness);
+}
+
+//====================== draw string ========================//
+/**
+ *  @brief Draw string
+ *
  *	To draw string font has to be selected.
  *
  *	WARNING: This works only for NULL-terminated strings!
  *
- *  @param[in] frame_buffer
- *             array of pixel values
+ *  @param[in] canvas
+ *             canvas to draw on
  *  @param[in] text
- *             string with ASCII values
+ *             UTF-8 encoded string (ASCII strings are valid UTF-8)
  *  @param[in] x
  *             x position of bottom left corner of first character
  *  @param[in] y
@@ -653,16 +1750,261 @@ void draw_char(uint8_t *frame_buffer, uint8_t c, uint16_t x, uint16_t y, uint8_t
  * 	@param[in] brightness
  *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
  */
-void draw_text(uint8_t *frame_buffer, const char* text, uint16_t x, uint16_t y, uint8_t brightness)
+void draw_text(GFXcanvas *canvas, const char* text, uint16_t x, uint16_t y, uint8_t brightness)
 {
     while (*text)
     {
-        draw_char(frame_buffer, *text, x, y, brightness);
-        x = x + gfx_font->glyph[*text-32].xAdvance;
-        text++;
+        uint8_t length;
+        const GFXglyph *glyph = find_glyph(canvas->font, utf8_decode(text, &length));
+        if (glyph != NULL)
+        {
+            put_glyph(canvas, canvas->font, glyph, x, y, brightness);
+            x = x + glyph->xAdvance;
+        }
+        text += length;
     }
 }
 
+//====================== measure part of string ========================//
+/**
+ *  @brief Measures first length bytes of a string with given font.
+ */
+static void measure_span(const GFXfont *font, const char *text, uint16_t length, GFXtext_metrics *metrics)
+{
+	int16_t x = 0;
+	int16_t left = INT16_MAX, top = INT16_MAX, right = INT16_MIN, bottom = INT16_MIN;
+	const char *end = text + length;
+
+	while (text < end)
+	{
+		uint8_t char_length;
+		const GFXglyph *glyph = find_glyph(font, utf8_decode(text, &char_length));
+		text += char_length;
+		if (glyph == NULL)
+			continue;
+
+		if (glyph->width && glyph->height)
+		{
+			if (x + glyph->xOffset < left)
+				left = x + glyph->xOffset;
+			if (x + glyph->xOffset + glyph->width > right)
+				right = x + glyph->xOffset + glyph->width;
+			if (glyph->yOffset < top)
+				top = glyph->yOffset;
+			if (glyph->yOffset + glyph->height > bottom)
+				bottom = glyph->yOffset + glyph->height;
+		}
+		x += glyph->xAdvance;
+	}
+
+	metrics->advance = x;
+	if (left > right)
+	{
+		metrics->x = metrics->y = 0;
+		metrics->width = metrics->height = 0;
+		return;
+	}
+	metrics->x = left;
+	metrics->y = top;
+	metrics->width = right - left;
+	metrics->height = bottom - top;
+}
+
+//====================== measure string ========================//
+/**
+ *  @brief Measures string without drawing it
+ *
+ *	Uses only glyph metrics of selected font, frame buffer is not touched.
+ *	Bounding box is given relative to the point where draw_text() would start drawing,
+ *	so text drawn at (x, y) covers pixels from (x + metrics.x, y + metrics.y)
+ *	to (x + metrics.x + metrics.width - 1, y + metrics.y + metrics.height - 1).
+ *
+ *  @param[in] canvas
+ *             canvas with selected font
+ *  @param[in] text
+ *             UTF-8 encoded string
+ *  @param[out] metrics
+ *             bounding box and cursor advance of the string, all zeros for empty string
+ */
+void measure_text(const GFXcanvas *canvas, const char *text, GFXtext_metrics *metrics)
+{
+	measure_span(canvas->font, text, strlen(text), metrics);
+}
+
+//====================== font extent ========================//
+/**
+ *  @brief Finds how far glyphs of a font reach above and below baseline.
+ *
+ *  Placing baseline (ascent) pixels below top of an area makes the highest glyph touch its top,
+ *  so lines of text drawn this way are aligned the same regardless of characters they contain.
+ *
+ *  @param[in] font
+ *             font to measure
+ *  @param[out] ascent
+ *             max height of glyphs above baseline
+ *  @param[out] descent
+ *             max depth of glyphs below baseline
+ */
+void font_extent(const GFXfont *font, uint8_t *ascent, uint8_t *descent)
+{
+	int16_t top = 0, bottom = 0;
+	uint16_t glyph_count = font_glyph_count(font);
+
+	for (uint16_t i = 0; i < glyph_count; i++)
+	{
+		if (-font->glyph[i].yOffset > top)
+			top = -font->glyph[i].yOffset;
+		if (font->glyph[i].yOffset + font->glyph[i].height > bottom)
+			bottom = font->glyph[i].yOffset + font->glyph[i].height;
+	}
+	*ascent = top;
+	*descent = bottom;
+}
+
+//====================== char advance ========================//
+/**
+ *  @brief Returns cursor advance of a character, 0 if it is not included in font.
+ */
+static uint16_t char_advance(const GFXfont *font, uint32_t c)
+{
+	const GFXglyph *glyph = find_glyph(font, c);
+	return glyph ? glyph->xAdvance : 0;
+}
+
+//====================== layout text in a box ========================//
+/**
+ *  @brief Splits text into lines that fit in a box and computes their positions
+ *
+ *	Text is wrapped between words, words longer than box width are split. New line character
+ *	always starts a new line. Lines that do not fit in box height or above TEXT_LAYOUT_MAX_LINES
+ *	are dropped. Only glyph metrics of selected font are used, frame buffer is not touched.
+ *
+ *	Layout keeps pointer to the text, so text has to stay unchanged as long as layout is drawn.
+ *	Static labels can be laid out once and drawn with draw_text_layout() every frame.
+ *
+ *  @param[in] canvas
+ *             canvas with selected font
+ *  @param[out] layout
+ *             computed layout
+ *  @param[in] text
+ *             UTF-8 encoded string
+ *  @param[in] box
+ *             area that text is laid out in
+ *  @param[in] align
+ *             GFX_ALIGN_LEFT, GFX_ALIGN_CENTER or GFX_ALIGN_RIGHT
+ *
+ *  @return amount of lines in layout
+ */
+uint8_t layout_text(const GFXcanvas *canvas, GFXtext_layout *layout, const char *text, const GFXrect *box, uint8_t align)
+{
+	const GFXfont *font = canvas->font;
+	uint16_t box_width = box->x1 - box->x0 + 1;
+	uint16_t box_height = box->y1 - box->y0 + 1;
+
+	layout->font = font;
+	layout->text = text;
+	layout->line_count = 0;
+	if (font == NULL)
+		return 0;
+
+	//first baseline is placed so that the highest glyph of font touches top of the box,
+	//line is kept only if the lowest glyph (descenders) still fits above bottom of the box
+	uint8_t ascent, descent;
+	font_extent(font, &ascent, &descent);
+
+	uint16_t pos = 0;
+	uint16_t baseline = ascent;
+	while (text[pos] && layout->line_count < TEXT_LAYOUT_MAX_LINES && (uint32_t)baseline + descent <= box_height)
+	{
+		uint16_t start = pos;
+		uint16_t width = 0;
+		uint16_t end = pos;          //end of last whole word in line
+		uint16_t end_width = 0;      //width of line up to end of last whole word
+
+		while (text[pos] && text[pos] != '\n')
+		{
+			uint8_t char_length;
+			uint16_t advance = char_advance(font, utf8_decode(text + pos, &char_length));
+			if (text[pos] != ' ' && width + advance > box_width)
+			{
+				if (end == start)
+				{
+					//word longer than box is split, but at least one character goes to each line
+					if (pos == start)
+					{
+						width += advance;
+						pos += char_length;
+					}
+					end = pos;
+					end_width = width;
+				}
+				pos = end;
+				break;
+			}
+
+			width += advance;
+			pos += char_length;
+			if (text[pos - 1] != ' ' && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == 0))
+			{
+				end = pos;
+				end_width = width;
+			}
+		}
+
+		while (text[pos] == ' ')
+			pos++;
+		if (text[pos] == '\n')
+			pos++;
+
+		int16_t x = box->x0;
+		if (align == GFX_ALIGN_CENTER)
+			x += (int16_t)(box_width - end_width) / 2;
+		else if (align == GFX_ALIGN_RIGHT)
+			x += box_width - end_width;
+
+		layout->lines[layout->line_count].start = start;
+		layout->lines[layout->line_count].length = end - start;
+		layout->lines[layout->line_count].x = x;
+		layout->lines[layout->line_count].y = box->y0 + baseline;
+		layout->line_count++;
+		baseline += font->yAdvance;
+	}
+	return layout->line_count;
+}
+
+//====================== draw text layout ========================//
+/**
+ *  @brief Draws text prepared by layout_text()
+ *
+ *	Font stored in layout is used, regardless of currently selected font.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] layout
+ *             layout computed by layout_text()
+ * 	@param[in] brightness
+ *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
+ */
+void draw_text_layout(GFXcanvas *canvas, const GFXtext_layout *layout, uint8_t brightness)
+{
+	for (uint8_t i = 0; i < layout->line_count; i++)
+	{
+		const char *text = layout->text + layout->lines[i].start;
+		const char *end = text + layout->lines[i].length;
+		uint16_t x = layout->lines[i].x;
+		while (text < end)
+		{
+			uint8_t char_length;
+			const GFXglyph *glyph = find_glyph(layout->font, utf8_decode(text, &char_length));
+			text += char_length;
+			if (glyph == NULL)
+				continue;
+			put_glyph(canvas, layout->font, glyph, x, layout->lines[i].y, brightness);
+			x += glyph->xAdvance;
+		}
+	}
+}
+
 //====================== send frame buffer to OLED ========================//
 /**
  *  @brief Sends frame buffer to OLED display.
@@ -673,16 +2015,188 @@ void draw_text(uint8_t *frame_buffer, const char* text, uint16_t x, uint16_t y,
  *  If you use bigger frame buffer, you can use this parameters to choose region of your frame buffer
  *  that will be displayed on OLED. This is particularly useful for scrolling.
  *
- *  @param[in] frame_buffer
- *             array of pixel values
+ *  Both positions are in pixels. start_x used to be a byte offset in the frame buffer, code written
+ *  for that has to pass twice the value now. The region is moved back inside the canvas if it would
+ *  reach past its edge, canvas smaller than OLED is sent to the top left corner of the display.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
  *  @param[in] start_x
- *             x position of frame buffer part that will be displayed on OLED. Useful for horizontal scrolling.
+ *             x position in pixels of frame buffer part that will be displayed on OLED, rounded down to even.
+ *             Useful for horizontal scrolling.
  *  @param[in] start_y
  *             y position of frame buffer part that will be displayed on OLED Useful for vertical scrolling.
 
  */
-void send_buffer_to_OLED(uint8_t *frame_buffer, uint16_t start_x, uint16_t start_y)
+void send_buffer_to_OLED(GFXcanvas *canvas, uint16_t start_x, uint16_t start_y)
+{
+	if (canvas->width < OLED_WIDTH || canvas->height < OLED_HEIGHT)
+	{
+		send_rect_to_OLED(canvas, 0, 0, canvas->width - 1, canvas->height - 1);
+		return;
+	}
+	if (start_x > canvas->width - OLED_WIDTH)
+		start_x = canvas->width - OLED_WIDTH;
+	if (start_y > canvas->height - OLED_HEIGHT)
+		start_y = canvas->height - OLED_HEIGHT;
+
+	uint8_t *start = canvas->buffer + (uint32_t)start_y * canvas->stride + start_x / 2;
+
+	SSD1322_API_set_window(canvas->device, 0, 63, 0, 127);
+	if (canvas->stride == OLED_WIDTH / 2)
+	{
+		SSD1322_API_send_buffer(canvas->device, start, OLED_WIDTH * OLED_HEIGHT / 2);
+		return;
+	}
+
+	//rows of wider buffer are not contiguous, so they are sent one by one
+	SSD1322_API_command(canvas->device, ENABLE_RAM_WRITE);
+	for (uint16_t i = 0; i < OLED_HEIGHT; i++)
+	{
+		SSD1322_API_data_array(canvas->device, start, OLED_WIDTH / 2);
+		start += canvas->stride;
+	}
+}
+
+
+//====================== send part of frame buffer to OLED ========================//
+/**
+ *  @brief Sends rectangular part of frame buffer to OLED display.
+ *
+ *  Only rows y0-y1 and columns x0-x1 are transmitted, which is much faster than sending whole
+ *  frame buffer when just a small area has changed. Frame buffer coordinates are equal to OLED
+ *  coordinates, so this works as a partial version of send_buffer_to_OLED(canvas, 0, 0).
+ *
+ *  SSD1322 addresses columns in groups of 4 pixels, so horizontal range is extended to
+ *  the nearest multiples of 4, pixels of that extension beyond the frame buffer width are sent
+ *  black. Parts outside of frame buffer or OLED are not sent.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] x0
+ *             x position of top left corner of the area
+ *  @param[in] y0
+ *             y position of top left corner of the area
+ *  @param[in] x1
+ *             x position of bottom right corner of the area
+ *  @param[in] y1
+ *             y position of bottom right corner of the area
+ */
+void send_rect_to_OLED(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
 {
-	SSD1322_API_set_window(0, 63, 0, 127);
-	SSD1322_API_send_buffer(frame_buffer + (start_y * OLED_WIDTH / 2) + start_x, 8192);
+	uint16_t max_x = (canvas->width < OLED_WIDTH ? canvas->width : OLED_WIDTH) - 1;
+	uint16_t max_y = (canvas->height < OLED_HEIGHT ? canvas->height : OLED_HEIGHT) - 1;
+
+	if (x0 > x1 || y0 > y1 || x0 > max_x || y0 > max_y)
+		return;
+	if (x1 > max_x)
+		x1 = max_x;
+	if (y1 > max_y)
+		y1 = max_y;
+
+	x0 &= ~3;          //align to 4 pixel wide SSD1322 columns
+	x1 |= 3;
+
+	//last column can reach past the buffer width, the missing pixels are sent black
+	static const uint8_t blank[2] = { 0, 0 };
+	uint16_t row_bytes = (x1 - x0 + 1) / 2;
+	uint16_t buffer_bytes = (canvas->width + 1) / 2 - x0 / 2;
+	if (buffer_bytes > row_bytes)
+		buffer_bytes = row_bytes;
+	uint8_t *row = canvas->buffer + (uint32_t)y0 * canvas->stride + x0 / 2;
+
+	SSD1322_API_set_window(canvas->device, x0 / 4, x1 / 4, y0, y1);
+	SSD1322_API_command(canvas->device, ENABLE_RAM_WRITE);
+	for (uint32_t i = y0; i <= y1; i++)
+	{
+		SSD1322_API_data_array(canvas->device, row, buffer_bytes);
+		if (buffer_bytes < row_bytes)
+			SSD1322_API_data_array(canvas->device, blank, row_bytes - buffer_bytes);
+		row += canvas->stride;
+	}
+}
+
+//====================== clear damage list ========================//
+/**
+ *  @brief Empties list of changed areas.
+ *
+ *  @param[out] damage
+ *             list to clear
+ */
+void damage_clear(GFXdamage *damage)
+{
+	damage->count = 0;
+}
+
+//====================== add damaged area ========================//
+/**
+ *  @brief Adds changed area of frame buffer to damage list.
+ *
+ *  Areas overlapping the new one are merged with it, so every pixel is sent only once.
+ *  When list is full, the last area grows to cover the new one.
+ *
+ *  @param[in,out] damage
+ *             list of changed areas
+ *  @param[in] rect
+ *             changed area in frame buffer coordinates
+ */
+void damage_add(GFXdamage *damage, const GFXrect *rect)
+{
+	GFXrect area = *rect;
+	uint8_t i = 0;
+
+	//every area swallowed by the new one is removed, then search starts again for the grown area
+	while (i < damage->count)
+	{
+		GFXrect *r = &damage->rects[i];
+		if (r->x0 > area.x1 || area.x0 > r->x1 || r->y0 > area.y1 || area.y0 > r->y1)
+		{
+			i++;
+			continue;
+		}
+		if (r->x0 < area.x0)
+			area.x0 = r->x0;
+		if (r->y0 < area.y0)
+			area.y0 = r->y0;
+		if (r->x1 > area.x1)
+			area.x1 = r->x1;
+		if (r->y1 > area.y1)
+			area.y1 = r->y1;
+		damage->rects[i] = damage->rects[--damage->count];
+		i = 0;
+	}
+
+	if (damage->count < GFX_DAMAGE_MAX_RECTS)
+	{
+		damage->rects[damage->count++] = area;
+		return;
+	}
+
+	GFXrect *last = &damage->rects[GFX_DAMAGE_MAX_RECTS - 1];
+	if (area.x0 < last->x0)
+		last->x0 = area.x0;
+	if (area.y0 < last->y0)
+		last->y0 = area.y0;
+	if (area.x1 > last->x1)
+		last->x1 = area.x1;
+	if (area.y1 > last->y1)
+		last->y1 = area.y1;
+}
+
+//====================== send damaged areas to OLED ========================//
+/**
+ *  @brief Sends all areas from damage list with send_rect_to_OLED() and clears the list.
+ *
+ *  @param[in] canvas
+ *             canvas to send
+ *  @param[in,out] damage
+ *             list of changed areas
+ */
+void send_damage_to_OLED(GFXcanvas *canvas, GFXdamage *damage)
+{
+	for (uint8_t i = 0; i < damage->count; i++)
+	{
+		send_rect_to_OLED(canvas, damage->rects[i].x0, damage->rects[i].y0, damage->rects[i].x1, damage->rects[i].y1);
+	}
+	damage->count = 0;
 }
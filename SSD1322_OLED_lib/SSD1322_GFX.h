@@ -20,11 +20,34 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_HW_Driver.h"
+
 /*============ defines ============*/
 
 #define OLED_HEIGHT 64
 #define OLED_WIDTH 256
 
+#define GFX_ROTATION_0   0
+#define GFX_ROTATION_90  1
+#define GFX_ROTATION_180 2
+#define GFX_ROTATION_270 3
+
+#define GFX_SCALE_NEAREST  0
+#define GFX_SCALE_BILINEAR 1
+
+#define GFX_ALIGN_LEFT   0
+#define GFX_ALIGN_CENTER 1
+#define GFX_ALIGN_RIGHT  2
+
+#define TEXT_LAYOUT_MAX_LINES 8
+
+#define UTF8_REPLACEMENT_CHAR 0xFFFD
+
+#define GFX_DAMAGE_MAX_RECTS 16
+
 /*============ Adafruit fonts structures ============*/
 
 // Single character data (glyph)
@@ -37,35 +60,111 @@ typedef struct {
   int8_t yOffset;        ///< Y dist from cursor pos to UL corner
 } GFXglyph;
 
-// Font data
+// Font data, Adafruit fonts set the fields after yAdvance to NULL and 0
 typedef struct {
-  uint8_t *bitmap;  ///< Glyph bitmaps, concatenated
-  GFXglyph *glyph;  ///< Glyph array
-  uint16_t first;   ///< ASCII extents (first char)
-  uint16_t last;    ///< ASCII extents (last char)
-  uint8_t yAdvance; ///< Newline distance (y axis)
+  uint8_t *bitmap;             ///< Glyph bitmaps, concatenated
+  GFXglyph *glyph;             ///< Glyph array
+  uint16_t first;              ///< ASCII extents (first char)
+  uint16_t last;               ///< ASCII extents (last char)
+  uint8_t yAdvance;            ///< Newline distance (y axis)
+  const uint16_t *codepoints;  ///< Sparse fonts only: sorted codepoints of glyphs, NULL for first..last range
+  uint16_t glyph_count;        ///< Sparse fonts only: amount of glyphs and codepoints
+  const uint8_t *(*load_bitmap)(void *loader, const GFXglyph *glyph);  ///< External fonts only: returns bitmap of a glyph, NULL if not used
+  void *loader;                ///< External fonts only: passed to load_bitmap
 } GFXfont;
 
+/*============ GFX structures ============*/
+
+// Rectangular area of frame buffer, corners are included
+typedef struct {
+  uint16_t x0; ///< x position of top left corner
+  uint16_t y0; ///< y position of top left corner
+  uint16_t x1; ///< x position of bottom right corner
+  uint16_t y1; ///< y position of bottom right corner
+} GFXrect;
+
+// Size of a string drawn with selected font
+typedef struct {
+  int16_t x;        ///< Left edge of bounding box relative to text start position
+  int16_t y;        ///< Top edge of bounding box relative to baseline (negative above baseline)
+  uint16_t width;   ///< Bounding box width in pixels
+  uint16_t height;  ///< Bounding box height in pixels
+  uint16_t advance; ///< Distance from text start to the position of next character
+} GFXtext_metrics;
+
+// Text split into lines and aligned inside a box
+typedef struct {
+  const GFXfont *font;   ///< Font used for layout
+  const char *text;      ///< Laid out string
+  uint8_t line_count;    ///< Amount of lines
+  struct {
+    uint16_t start;      ///< Index of first character of a line
+    uint16_t length;     ///< Amount of characters in a line
+    int16_t x;           ///< x position of line start
+    int16_t y;           ///< y position of line baseline
+  } lines[TEXT_LAYOUT_MAX_LINES];
+} GFXtext_layout;
+
+// Changed areas of frame buffer waiting to be sent to OLED
+typedef struct {
+  uint8_t count;                        ///< Amount of areas
+  GFXrect rects[GFX_DAMAGE_MAX_RECTS];  ///< Areas in frame buffer coordinates, not overlapping
+} GFXdamage;
+
+// Frame buffer together with drawing state
+typedef struct {
+  uint8_t *buffer;       ///< Pixels, 4 bits per pixel, even x in high nibble
+  uint16_t width;        ///< Width in pixels
+  uint16_t height;       ///< Height in pixels
+  uint16_t stride;       ///< Distance between rows in bytes
+  const GFXfont *font;   ///< Font selected with select_font()
+  GFXrect clip;          ///< Drawable area in frame buffer coordinates
+  uint8_t rotation;      ///< GFX_ROTATION_0, GFX_ROTATION_90, GFX_ROTATION_180 or GFX_ROTATION_270
+  SSD1322_device_t *device; ///< Display that canvas is sent to
+} GFXcanvas;
+
 /*============ functions ============*/
 
-void set_buffer_size(uint16_t buffer_width, uint16_t buffer_height);
-void fill_buffer(uint8_t *frame_buffer, uint8_t brightness);
-void draw_pixel(uint8_t *frame_buffer, uint16_t x, uint16_t y, uint8_t brightness);
-void draw_vline(uint8_t *frame_buffer, uint16_t x, uint16_t y0, uint16_t y1, uint8_t brightness);
-void draw_hline(uint8_t *frame_buffer, uint16_t y, uint16_t x0, uint16_t x1, uint8_t brightness);
-void draw_line(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness);
-void draw_AA_line(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness);
-void draw_rect(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t x2, uint8_t brightness);
-void draw_rect_filled(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t x2, uint8_t brightness);
-void draw_circle(uint8_t *frame_buffer, uint16_t x0, uint16_t y0, uint16_t r, uint8_t brightness);
-void draw_bitmap_8bpp(uint8_t *frame_buffer, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size);
-void draw_bitmap_4bpp(uint8_t *frame_buffer, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size);
-
-void select_font(const GFXfont *new_gfx_font);
-void draw_char(uint8_t *frame_buffer, uint8_t text, uint16_t x, uint16_t y, uint8_t brightness);
-void draw_text(uint8_t *frame_buffer, const char* text, uint16_t x, uint16_t y, uint8_t brightness);
-
-void send_buffer_to_OLED(uint8_t *frame_buffer, uint16_t start_x, uint16_t start_y);
+void canvas_init(GFXcanvas *canvas, uint8_t *buffer, uint16_t width, uint16_t height);
+void canvas_set_clip(GFXcanvas *canvas, const GFXrect *clip);
+void canvas_reset_clip(GFXcanvas *canvas);
+void set_rotation(GFXcanvas *canvas, uint8_t rotation);
+void fill_buffer(GFXcanvas *canvas, uint8_t brightness);
+void draw_pixel(GFXcanvas *canvas, uint16_t x, uint16_t y, uint8_t brightness);
+uint8_t get_pixel(const GFXcanvas *canvas, uint16_t x, uint16_t y);
+void draw_vline(GFXcanvas *canvas, uint16_t x, uint16_t y0, uint16_t y1, uint8_t brightness);
+void draw_hline(GFXcanvas *canvas, uint16_t y, uint16_t x0, uint16_t x1, uint8_t brightness);
+void draw_line(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness);
+void draw_AA_line(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t brightness);
+void draw_rect(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t x2, uint8_t brightness);
+void draw_rect_filled(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t x2, uint8_t brightness);
+void draw_circle(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t r, uint8_t brightness);
+void draw_bitmap_8bpp(GFXcanvas *canvas, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size);
+void draw_bitmap_4bpp(GFXcanvas *canvas, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size);
+void draw_bitmap_1bpp(GFXcanvas *canvas, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size,
+		uint8_t foreground, uint8_t background);
+void draw_bitmap_1bpp_transparent(GFXcanvas *canvas, const uint8_t *bitmap, uint16_t x0, uint16_t y0, uint16_t x_size, uint16_t y_size,
+		uint8_t brightness);
+void draw_bitmap_scaled(GFXcanvas *canvas, const uint8_t *bitmap, uint8_t bpp, uint16_t x_size, uint16_t y_size,
+		uint16_t x0, uint16_t y0, uint16_t dst_x_size, uint16_t dst_y_size, uint8_t filter);
+
+void scroll_rect(GFXcanvas *canvas, const GFXrect *rect, int16_t dx, int16_t dy, uint8_t brightness);
+void copy_rect(GFXcanvas *dst, uint16_t x, uint16_t y, const GFXcanvas *src, const GFXrect *rect);
+
+void select_font(GFXcanvas *canvas, const GFXfont *new_gfx_font);
+void draw_char(GFXcanvas *canvas, uint32_t c, uint16_t x, uint16_t y, uint8_t brightness);
+void draw_text(GFXcanvas *canvas, const char* text, uint16_t x, uint16_t y, uint8_t brightness);
+void measure_text(const GFXcanvas *canvas, const char *text, GFXtext_metrics *metrics);
+void font_extent(const GFXfont *font, uint8_t *ascent, uint8_t *descent);
+uint8_t layout_text(const GFXcanvas *canvas, GFXtext_layout *layout, const char *text, const GFXrect *box, uint8_t align);
+void draw_text_layout(GFXcanvas *canvas, const GFXtext_layout *layout, uint8_t brightness);
+
+void send_buffer_to_OLED(GFXcanvas *canvas, uint16_t start_x, uint16_t start_y);
+void send_rect_to_OLED(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+
+void damage_clear(GFXdamage *damage);
+void damage_add(GFXdamage *damage, const GFXrect *rect);
+void send_damage_to_OLED(GFXcanvas *canvas, GFXdamage *damage);
 
 #ifdef __cplusplus
 }
@@ -24,6 +24,8 @@
 
 #include "../SSD1322_OLED_lib/SSD1322_HW_Driver.h"
 
+#include <stddef.h>
+
 //====================== CS pin low ========================//
 /**
  *  @brief Drives CS (Chip Select) pin of SPI interface low.
@@ -127,3 +129,57 @@ void SSD1322_HW_msDelay(uint32_t milliseconds)
 {
 	HAL_Delay(milliseconds);
 }
+
+//====================== default device ========================//
+/*
+ *  Functions above wrapped for SSD1322_HW_ops_t. To connect more displays, copy these wrappers
+ *  and pass pins of each display through context pointer.
+ */
+static void default_drive_CS(void *context, uint8_t level)
+{
+	(void)context;
+
+	if (level)
+		SSD1322_HW_drive_CS_high();
+	else
+		SSD1322_HW_drive_CS_low();
+}
+
+static void default_drive_DC(void *context, uint8_t level)
+{
+	(void)context;
+
+	if (level)
+		SSD1322_HW_drive_DC_high();
+	else
+		SSD1322_HW_drive_DC_low();
+}
+
+static void default_drive_RESET(void *context, uint8_t level)
+{
+	(void)context;
+
+	if (level)
+		SSD1322_HW_drive_RESET_high();
+	else
+		SSD1322_HW_drive_RESET_low();
+}
+
+static void default_SPI_send_array(void *context, const uint8_t *array, uint32_t size)
+{
+	(void)context;
+
+	SSD1322_HW_SPI_send_array((uint8_t *)array, size);
+}
+
+static const SSD1322_HW_ops_t default_ops =
+{
+	default_drive_CS,
+	default_drive_DC,
+	default_drive_RESET,
+	default_SPI_send_array,
+	NULL,
+	SSD1322_HW_msDelay
+};
+
+SSD1322_device_t SSD1322_HW_default_device = { &default_ops, NULL };
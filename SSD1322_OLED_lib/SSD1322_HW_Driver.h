@@ -25,6 +25,30 @@ extern "C" {
 
 #include <stdint.h>
 
+/*============ per-device hardware access ============*/
+
+// Hardware functions of one display. Displays sharing SPI bus use the same SPI functions
+// and differ in pins, which are selected by context pointer.
+typedef struct {
+  void (*drive_CS)(void *context, uint8_t level);                                  ///< Drive CS pin low (0) or high (1)
+  void (*drive_DC)(void *context, uint8_t level);                                  ///< Drive DC pin low (0) or high (1)
+  void (*drive_RESET)(void *context, uint8_t level);                               ///< Drive RESET pin low (0) or high (1)
+  void (*SPI_send_array)(void *context, const uint8_t *array, uint32_t size);     ///< Blocking SPI transfer
+  uint8_t (*SPI_start_array)(void *context, const uint8_t *array, uint32_t size); ///< Optional non blocking transfer, NULL if not used
+  void (*msDelay)(uint32_t milliseconds);                                          ///< Wait for x milliseconds
+} SSD1322_HW_ops_t;
+
+// Single SSD1322 display
+typedef struct {
+  const SSD1322_HW_ops_t *hw;   ///< Hardware functions
+  void *context;                ///< Passed to hardware functions, for example pins of this display
+} SSD1322_device_t;
+
+// Display connected to pins defined in SSD1322_HW_Driver.c
+extern SSD1322_device_t SSD1322_HW_default_device;
+
+/*============ hardware functions of default device ============*/
+
 void SSD1322_HW_drive_CS_low();
 void SSD1322_HW_drive_CS_high();
 void SSD1322_HW_drive_DC_low();
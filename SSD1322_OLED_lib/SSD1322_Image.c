@@ -0,0 +1,375 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Image.c
+ *
+ * \brief Row by row decoding of PGM and grayscale BMP images read through a callback.
+ *
+ * Header is parsed by image_open(), then every image_read_row() reads one row and turns
+ * it into 8-bit gray values: PGM samples are scaled to 0-255, BMP color indexes are looked up
+ * in palette. Rows are reduced to 16 levels with SSD1322_Dither, so the same error diffusion
+ * as for compiled in bitmaps can be used.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_API.h"
+#include "../SSD1322_OLED_lib/SSD1322_Dither.h"
+#include "../SSD1322_OLED_lib/SSD1322_Image.h"
+
+//====================== read bytes ========================//
+/**
+ *  @brief Reads exactly size bytes, read function may return less at once.
+ *
+ *  @return 1 if all bytes were read, 0 if data ended
+ */
+static uint8_t read_exact(GFXimage *image, uint8_t *buffer, uint32_t size)
+{
+	while (size > 0)
+	{
+		uint32_t amount = image->read(image->context, buffer, size);
+		if (amount == 0 || amount > size)
+			return 0;
+		buffer += amount;
+		size -= amount;
+	}
+	return 1;
+}
+
+//====================== skip bytes ========================//
+static uint8_t skip_bytes(GFXimage *image, uint32_t size)
+{
+	uint8_t trash[16];
+
+	while (size > 0)
+	{
+		uint32_t amount = size > sizeof(trash) ? sizeof(trash) : size;
+		if (!read_exact(image, trash, amount))
+			return 0;
+		size -= amount;
+	}
+	return 1;
+}
+
+//====================== little endian numbers ========================//
+static uint16_t get_u16(const uint8_t *bytes)
+{
+	return bytes[0] | (bytes[1] << 8);
+}
+
+static uint32_t get_u32(const uint8_t *bytes)
+{
+	return bytes[0] | (bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+//====================== PGM header number ========================//
+/**
+ *  @brief Reads decimal number of PGM header, skipping whitespace and comments before it.
+ *
+ *  Single whitespace character after the number is consumed too.
+ */
+static uint8_t pgm_number(GFXimage *image, uint16_t *value)
+{
+	uint32_t number = 0;
+	uint8_t c;
+
+	do
+	{
+		if (!read_exact(image, &c, 1))
+			return 0;
+		if (c == '#')
+		{
+			while (c != '\n')
+			{
+				if (!read_exact(image, &c, 1))
+					return 0;
+			}
+		}
+	} while (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+
+	if (c < '0' || c > '9')
+		return 0;
+	while (c >= '0' && c <= '9')
+	{
+		number = number * 10 + c - '0';
+		if (number > 0xFFFF || !read_exact(image, &c, 1))
+			return 0;
+	}
+	*value = number;
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+//====================== PGM header ========================//
+static uint8_t open_pgm(GFXimage *image)
+{
+	image->format = IMAGE_PGM;
+	image->bpp = 8;
+	image->bottom_up = 0;
+	image->padding = 0;
+
+	if (!pgm_number(image, &image->width) || !pgm_number(image, &image->height) || !pgm_number(image, &image->max_value))
+		return 0;
+
+	//16-bit samples are not supported
+	return image->width > 0 && image->height > 0 && image->max_value > 0 && image->max_value <= 255;
+}
+
+//====================== BMP header ========================//
+static uint8_t open_bmp(GFXimage *image)
+{
+	uint8_t header[52];
+	uint32_t consumed = 2;
+
+	image->format = IMAGE_BMP;
+
+	//rest of file header and size of info header
+	if (!read_exact(image, header, 16))
+		return 0;
+	uint32_t data_offset = get_u32(&header[8]);
+	uint32_t info_size = get_u32(&header[12]);
+	consumed += 16;
+
+	//only BITMAPINFOHEADER and its newer versions
+	if (info_size < 40 || !read_exact(image, header + 16, 36))
+		return 0;
+	consumed += 36;
+
+	int32_t width = get_u32(&header[16]);
+	int32_t height = get_u32(&header[20]);
+	uint16_t planes = get_u16(&header[24]);
+	uint16_t bpp = get_u16(&header[26]);
+	uint32_t compression = get_u32(&header[28]);
+	uint32_t colors = get_u32(&header[44]);
+
+	if (planes != 1 || (bpp != 4 && bpp != 8) || compression != 0)
+		return 0;
+	if (width <= 0 || width > 0xFFFF || height == 0 || height > 0xFFFF || height < -0xFFFF)
+		return 0;
+
+	image->width = width;
+	image->height = height < 0 ? -height : height;
+	image->bottom_up = height > 0;
+	image->bpp = bpp;
+	image->padding = (4 - ((uint32_t)width * bpp + 7) / 8 % 4) % 4;
+
+	if (!skip_bytes(image, info_size - 40))
+		return 0;
+	consumed += info_size - 40;
+
+	//palette entries are blue, green, red and unused byte
+	if (colors == 0 || colors > (1U << bpp))
+		colors = 1U << bpp;
+	for (uint16_t i = 0; i < 256; i++)
+	{
+		image->palette[i] = 0;
+	}
+	for (uint16_t i = 0; i < colors; i++)
+	{
+		uint8_t entry[4];
+		if (!read_exact(image, entry, 4))
+			return 0;
+		image->palette[i] = (entry[0] * 29 + entry[1] * 150 + entry[2] * 77 + 128) >> 8;
+	}
+	consumed += colors * 4;
+
+	if (data_offset < consumed)
+		return 0;
+	return skip_bytes(image, data_offset - consumed);
+}
+
+//====================== open image ========================//
+/**
+ *  @brief Reads image header and prepares decoding.
+ *
+ *  Format is recognized from first bytes: "P5" for PGM and "BM" for BMP.
+ *
+ *  @param[out] image
+ *             image to prepare
+ *  @param[in] read
+ *             function reading next bytes of image, returns amount of bytes read, 0 at the end
+ *  @param[in] context
+ *             passed to read function
+ *
+ *  @return 1 if image can be decoded, 0 if format is wrong or not supported
+ */
+uint8_t image_open(GFXimage *image, uint32_t (*read)(void *context, uint8_t *buffer, uint32_t size), void *context)
+{
+	uint8_t magic[2];
+
+	image->read = read;
+	image->context = context;
+	image->rows_read = 0;
+	image->width = 0;
+	image->height = 0;
+
+	if (!read_exact(image, magic, 2))
+		return 0;
+	if (magic[0] == 'P' && magic[1] == '5')
+		return open_pgm(image);
+	if (magic[0] == 'B' && magic[1] == 'M')
+		return open_bmp(image);
+	return 0;
+}
+
+//====================== read row ========================//
+/**
+ *  @brief Reads next row of image as 8-bit gray values.
+ *
+ *  @param[in] image
+ *             image prepared with image_open()
+ *  @param[out] row
+ *             array of IMAGE_WORK_SIZE(width) bytes
+ *  @param[out] y
+ *             position of the row in image, rows of BMP come from the bottom
+ *
+ *  @return 1 if row was read, 0 if image ended or data is missing
+ */
+uint8_t image_read_row(GFXimage *image, uint8_t *row, uint16_t *y)
+{
+	uint16_t width = image->width;
+
+	if (image->rows_read >= image->height)
+		return 0;
+	if (!read_exact(image, row, image->bpp == 8 ? width : (width + 1) / 2) || !skip_bytes(image, image->padding))
+		return 0;
+
+	if (image->format == IMAGE_PGM)
+	{
+		if (image->max_value != 255)
+		{
+			for (uint16_t x = 0; x < width; x++)
+			{
+				uint16_t value = row[x] > image->max_value ? image->max_value : row[x];
+				row[x] = (value * 255 + image->max_value / 2) / image->max_value;
+			}
+		}
+	}
+	else if (image->bpp == 8)
+	{
+		for (uint16_t x = 0; x < width; x++)
+		{
+			row[x] = image->palette[row[x]];
+		}
+	}
+	else
+	{
+		//4-bit indexes are expanded in place from the end, so packed bytes are read before being overwritten
+		for (int32_t x = width - 1; x >= 0; x--)
+		{
+			uint8_t index = (x & 1) ? row[x / 2] & 0x0F : row[x / 2] >> 4;
+			row[x] = image->palette[index];
+		}
+	}
+
+	*y = image->bottom_up ? image->height - 1 - image->rows_read : image->rows_read;
+	image->rows_read++;
+	return 1;
+}
+
+//====================== draw image ========================//
+/**
+ *  @brief Decodes image row by row into canvas
+ *
+ *  Rows are clipped like in draw_bitmap_dithered().
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] image
+ *             image prepared with image_open()
+ *  @param[in] x0
+ *             x position of top left corner of drawn image
+ *  @param[in] y0
+ *             y position of top left corner of drawn image
+ *  @param[in] method
+ *             DITHER_NONE, DITHER_FLOYD_STEINBERG or DITHER_SIERRA_LITE
+ *  @param[in] work
+ *             array of IMAGE_WORK_SIZE(image->width) bytes
+ *  @param[in] dither_work
+ *             array of DITHER_WORK_SIZE(image->width) elements
+ *
+ *  @return 1 if whole image was drawn, 0 if data ended too early
+ */
+uint8_t draw_image(GFXcanvas *canvas, GFXimage *image, uint16_t x0, uint16_t y0, uint8_t method, uint8_t *work,
+		int16_t *dither_work)
+{
+	GFXdither dither;
+	uint16_t y;
+
+	dither_init(&dither, method, image->width, dither_work);
+	while (image->rows_read < image->height)
+	{
+		if (!image_read_row(image, work, &y))
+			return 0;
+		draw_dithered_row(canvas, &dither, work, x0, y0 + y);
+	}
+	return 1;
+}
+
+//====================== send image to OLED ========================//
+/**
+ *  @brief Decodes image row by row straight into display RAM, without frame buffer
+ *
+ *  Every row is sent as one row window. SSD1322 columns are 4 pixels wide, so x0 has to be
+ *  a multiple of 4 and pixels up to the next multiple of 4 after image width are cleared.
+ *  Parts outside of display are skipped.
+ *
+ *  @param[in] device
+ *             display to send image to
+ *  @param[in] image
+ *             image prepared with image_open()
+ *  @param[in] x0
+ *             x position of top left corner of image, multiple of 4
+ *  @param[in] y0
+ *             y position of top left corner of image
+ *  @param[in] method
+ *             DITHER_NONE, DITHER_FLOYD_STEINBERG or DITHER_SIERRA_LITE
+ *  @param[in] work
+ *             array of IMAGE_WORK_SIZE(image->width) bytes
+ *  @param[in] dither_work
+ *             array of DITHER_WORK_SIZE(image->width) elements
+ *
+ *  @return 1 if whole image was sent, 0 if data ended too early or image is empty
+ */
+uint8_t send_image_to_OLED(SSD1322_device_t *device, GFXimage *image, uint16_t x0, uint16_t y0, uint8_t method, uint8_t *work,
+		int16_t *dither_work)
+{
+	GFXdither dither;
+	uint16_t width = image->width;
+	uint16_t padded = IMAGE_WORK_SIZE(width);
+	uint16_t start_column = x0 / 4;
+	uint32_t end_column = start_column + padded / 4 - 1;
+	uint16_t y;
+
+	if (padded == 0)
+		return 0;
+	if (end_column > OLED_WIDTH / 4 - 1)
+		end_column = OLED_WIDTH / 4 - 1;
+
+	dither_init(&dither, method, width, dither_work);
+	while (image->rows_read < image->height)
+	{
+		if (!image_read_row(image, work, &y))
+			return 0;
+
+		//gray values are replaced by packed pixels in the same array
+		dither_pixels(&dither, work, width, work, 0);
+		if (width & 1)
+			work[width / 2] &= 0xF0;
+		for (uint16_t i = (width + 1) / 2; i < padded / 2; i++)
+		{
+			work[i] = 0;
+		}
+
+		if (start_column > end_column || (uint32_t)y0 + y >= OLED_HEIGHT)
+			continue;
+		SSD1322_API_set_window(device, start_column, end_column, y0 + y, y0 + y);
+		SSD1322_API_send_buffer(device, work, (end_column - start_column + 1) * 2);
+	}
+	return 1;
+}
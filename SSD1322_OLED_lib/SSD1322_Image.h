@@ -0,0 +1,67 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Image.h
+ *
+ * \brief Row by row decoding of PGM and grayscale BMP images read through a callback.
+ *
+ * Image can be read from SD card, flash chip or host link. Only one row is kept in memory,
+ * so images much bigger than RAM can be drawn.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_IMAGE_H
+#define SSD1322_IMAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Dither.h"
+
+/*============ defines ============*/
+
+#define IMAGE_PGM 0    ///< Binary portable graymap (P5), up to 255 levels
+#define IMAGE_BMP 1    ///< Uncompressed 4 or 8 bits per pixel BMP with palette
+
+// Size of work array for one row of image of given width
+#define IMAGE_WORK_SIZE(width)  ((((width) + 3) / 4) * 4)
+
+/*============ image structure ============*/
+
+typedef struct {
+  uint32_t (*read)(void *context, uint8_t *buffer, uint32_t size);  ///< Reads up to size bytes, returns amount read, 0 at the end
+  void *context;         ///< Passed to read function, for example opened file
+  uint8_t format;        ///< IMAGE_PGM or IMAGE_BMP
+  uint16_t width;        ///< Width in pixels
+  uint16_t height;       ///< Height in pixels
+  uint8_t bpp;           ///< Bits per pixel in file, 4 or 8
+  uint8_t bottom_up;     ///< 1 if the last row is stored first (usual for BMP)
+  uint8_t padding;       ///< Bytes skipped after every row
+  uint16_t max_value;    ///< PGM only: value of white
+  uint16_t rows_read;    ///< Amount of rows already decoded
+  uint8_t palette[256];  ///< BMP only: 8-bit gray value of every color index
+} GFXimage;
+
+/*============ functions ============*/
+
+uint8_t image_open(GFXimage *image, uint32_t (*read)(void *context, uint8_t *buffer, uint32_t size), void *context);
+uint8_t image_read_row(GFXimage *image, uint8_t *row, uint16_t *y);
+uint8_t draw_image(GFXcanvas *canvas, GFXimage *image, uint16_t x0, uint16_t y0, uint8_t method, uint8_t *work,
+		int16_t *dither_work);
+uint8_t send_image_to_OLED(SSD1322_device_t *device, GFXimage *image, uint16_t x0, uint16_t y0, uint8_t method, uint8_t *work,
+		int16_t *dither_work);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_IMAGE_H */
@@ -0,0 +1,343 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Layers.c
+ *
+ * \brief Layers with own frame buffers composed into output canvas.
+ *
+ * Damaged areas of all layers are collected in output coordinates in a damage list, which
+ * merges overlapping areas. Each area is composed line by line from the bottom layer to the top one.
+ * Layers are blended a byte (two pixels) at a time. Layer at odd x position is read with
+ * nibbles shifted by one pixel, so any position costs the same.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Layers.h"
+
+#include <string.h>
+
+//====================== init layer ========================//
+/**
+ *  @brief Prepares visible layer at (0, 0) over its own frame buffer.
+ *
+ *  Whole layer is marked as damaged, so it is composed on next compositor_update().
+ *
+ *  @param[in] layer
+ *             layer to prepare
+ *  @param[in] buffer
+ *             array of (width * height / 2) bytes for layer pixels
+ *  @param[in] width
+ *             width of layer in pixels, has to be even
+ *  @param[in] height
+ *             height of layer in pixels
+ *  @param[in] blend
+ *             LAYER_BLEND_OPAQUE, LAYER_BLEND_KEY, LAYER_BLEND_ADD or LAYER_BLEND_MAX
+ */
+void layer_init(GFXlayer *layer, uint8_t *buffer, uint16_t width, uint16_t height, uint8_t blend)
+{
+	canvas_init(&layer->canvas, buffer, width, height);
+	layer->x = 0;
+	layer->y = 0;
+	layer->visible = 1;
+	layer->blend = blend;
+	layer->key = 0;
+	layer->drawn = 0;
+	layer->drawn_x = 0;
+	layer->drawn_y = 0;
+	layer->drawn_blend = blend;
+	layer->drawn_key = 0;
+	layer_damage_all(layer);
+}
+
+//====================== damage layer area ========================//
+/**
+ *  @brief Marks area of layer that was drawn on.
+ *
+ *  Area is given in layer frame buffer coordinates (without rotation of layer canvas)
+ *  and is added to area damaged since last composition.
+ *
+ *  @param[in] layer
+ *             changed layer
+ *  @param[in] rect
+ *             changed area
+ */
+void layer_damage(GFXlayer *layer, const GFXrect *rect)
+{
+	if (!layer->damaged)
+	{
+		layer->damage = *rect;
+		layer->damaged = 1;
+		return;
+	}
+	if (rect->x0 < layer->damage.x0)
+		layer->damage.x0 = rect->x0;
+	if (rect->y0 < layer->damage.y0)
+		layer->damage.y0 = rect->y0;
+	if (rect->x1 > layer->damage.x1)
+		layer->damage.x1 = rect->x1;
+	if (rect->y1 > layer->damage.y1)
+		layer->damage.y1 = rect->y1;
+}
+
+//====================== damage whole layer ========================//
+/**
+ *  @brief Marks whole layer as changed.
+ */
+void layer_damage_all(GFXlayer *layer)
+{
+	GFXrect rect = { 0, 0, layer->canvas.width - 1, layer->canvas.height - 1 };
+	layer->damaged = 0;
+	layer_damage(layer, &rect);
+}
+
+//====================== move layer ========================//
+/**
+ *  @brief Sets new layer position. Takes effect on next compositor_update().
+ */
+void layer_move(GFXlayer *layer, int16_t x, int16_t y)
+{
+	layer->x = x;
+	layer->y = y;
+}
+
+//====================== show/hide layer ========================//
+/**
+ *  @brief Shows (1) or hides (0) layer. Takes effect on next compositor_update().
+ */
+void layer_show(GFXlayer *layer, uint8_t visible)
+{
+	layer->visible = visible;
+}
+
+//====================== set blend mode ========================//
+/**
+ *  @brief Sets blend mode of layer. Takes effect on next compositor_update().
+ *
+ *  @param[in] layer
+ *             changed layer
+ *  @param[in] blend
+ *             LAYER_BLEND_OPAQUE, LAYER_BLEND_KEY, LAYER_BLEND_ADD or LAYER_BLEND_MAX
+ *  @param[in] key
+ *             transparent brightness (0-15), used only by LAYER_BLEND_KEY
+ */
+void layer_set_blend(GFXlayer *layer, uint8_t blend, uint8_t key)
+{
+	layer->blend = blend;
+	layer->key = key;
+}
+
+//====================== add damaged area ========================//
+/**
+ *  @brief Clips area to output, widens it to whole bytes and adds it to compositor damage list.
+ */
+static void add_rect(GFXcompositor *compositor, int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+	int32_t width = compositor->output->width;
+	int32_t height = compositor->output->height;
+
+	if (x0 < 0)
+		x0 = 0;
+	if (y0 < 0)
+		y0 = 0;
+	if (x1 > width - 1)
+		x1 = width - 1;
+	if (y1 > height - 1)
+		y1 = height - 1;
+	if (x0 > x1 || y0 > y1)
+		return;
+
+	GFXrect rect = { x0 & ~1, y0, x1 | 1, y1 };
+	damage_add(&compositor->damage, &rect);
+}
+
+//====================== blend byte ========================//
+/**
+ *  @brief Blends two pixels of layer into two pixels of output.
+ *
+ *  @param[in] out
+ *             output byte
+ *  @param[in] src
+ *             layer byte
+ *  @param[in] mask
+ *             nibbles of output covered by layer
+ */
+static inline uint8_t blend_byte(uint8_t out, uint8_t src, uint8_t mask, uint8_t blend, uint8_t key)
+{
+	uint8_t hi, lo;
+
+	switch (blend)
+	{
+	case LAYER_BLEND_KEY:
+		if (((src ^ key) & 0xF0) == 0)
+			mask &= 0x0F;
+		if (((src ^ key) & 0x0F) == 0)
+			mask &= 0xF0;
+		break;
+	case LAYER_BLEND_ADD:
+		hi = (out >> 4) + (src >> 4);
+		lo = (out & 0x0F) + (src & 0x0F);
+		src = ((hi > 15 ? 15 : hi) << 4) | (lo > 15 ? 15 : lo);
+		break;
+	case LAYER_BLEND_MAX:
+		hi = (out & 0xF0) > (src & 0xF0) ? out & 0xF0 : src & 0xF0;
+		lo = (out & 0x0F) > (src & 0x0F) ? out & 0x0F : src & 0x0F;
+		src = hi | lo;
+		break;
+	}
+	return (out & ~mask) | (src & mask);
+}
+
+//====================== compose layer row ========================//
+/**
+ *  @brief Blends one row of layer into output row, between output pixels x0 and x1.
+ */
+static void compose_row(const GFXlayer *layer, uint8_t *out, int32_t y, int32_t x0, int32_t x1)
+{
+	int32_t lx0 = layer->x;
+	int32_t lx1 = layer->x + layer->canvas.width - 1;
+	if (x0 < lx0)
+		x0 = lx0;
+	if (x1 > lx1)
+		x1 = lx1;
+	if (x0 > x1)
+		return;
+
+	const uint8_t *row = layer->canvas.buffer + (y - layer->y) * layer->canvas.stride;
+	uint8_t key = layer->key * 0x11;
+
+	for (int32_t b = x0 / 2; b <= x1 / 2; b++)
+	{
+		int32_t lx = 2 * b - layer->x;    //layer pixel that lands in high nibble
+		uint8_t mask = 0xFF;
+		uint8_t src;
+
+		if (2 * b < x0)
+			mask &= 0x0F;
+		if (2 * b + 1 > x1)
+			mask &= 0xF0;
+
+		if ((layer->x & 1) == 0)
+		{
+			src = row[lx / 2];
+		}
+		else
+		{
+			//odd position - each output byte takes low nibble of one layer byte and high nibble of next one
+			src = 0;
+			if (mask & 0xF0)
+				src |= row[(lx - 1) / 2] << 4;
+			if (mask & 0x0F)
+				src |= row[(lx + 1) / 2] >> 4;
+		}
+		out[b] = blend_byte(out[b], src, mask, layer->blend, key);
+	}
+}
+
+//====================== compose area ========================//
+/**
+ *  @brief Composes all visible layers in given output area, line by line.
+ */
+static void compose_rect(GFXcompositor *compositor, const GFXrect *rect)
+{
+	GFXcanvas *output = compositor->output;
+
+	for (uint16_t y = rect->y0; y <= rect->y1; y++)
+	{
+		uint8_t *out = output->buffer + (uint32_t)y * output->stride;
+		memset(out + rect->x0 / 2, 0x00, (rect->x1 - rect->x0 + 1) / 2);
+
+		for (uint8_t i = 0; i < compositor->count; i++)
+		{
+			const GFXlayer *layer = compositor->layers[i];
+			if (!layer->visible || y < layer->y || y >= layer->y + layer->canvas.height)
+				continue;
+			compose_row(layer, out, y, rect->x0, rect->x1);
+		}
+	}
+}
+
+//====================== init compositor ========================//
+/**
+ *  @brief Prepares compositor. Whole output is composed on first compositor_update().
+ *
+ *  @param[in] compositor
+ *             compositor to prepare
+ *  @param[in] output
+ *             canvas that layers are composed into, its rotation and clipping are not used
+ *  @param[in] layers
+ *             array of pointers to layers, first one is at the bottom
+ *  @param[in] count
+ *             amount of layers
+ */
+void compositor_init(GFXcompositor *compositor, GFXcanvas *output, GFXlayer **layers, uint8_t count)
+{
+	compositor->output = output;
+	compositor->layers = layers;
+	compositor->count = count;
+	damage_clear(&compositor->damage);
+	add_rect(compositor, 0, 0, output->width - 1, output->height - 1);
+}
+
+//====================== update compositor ========================//
+/**
+ *  @brief Composes damaged areas of all layers and optionally sends them to OLED.
+ *
+ *  Damaged area of layer is its damage rectangle, or whole layer at old and new position
+ *  if it was moved, shown, hidden or its blend mode has changed. Overlapping areas are merged
+ *  and each area is composed once, from the bottom layer to the top one.
+ *
+ *  @param[in] compositor
+ *             compositor with layers
+ *  @param[in] upload
+ *             1 to send composed areas with send_rect_to_OLED(), 0 to only update output canvas
+ *
+ *  @return amount of composed areas
+ */
+uint8_t compositor_update(GFXcompositor *compositor, uint8_t upload)
+{
+	for (uint8_t i = 0; i < compositor->count; i++)
+	{
+		GFXlayer *layer = compositor->layers[i];
+		uint8_t changed = layer->visible != layer->drawn || layer->x != layer->drawn_x || layer->y != layer->drawn_y
+				|| layer->blend != layer->drawn_blend || layer->key != layer->drawn_key;
+
+		if (changed && layer->drawn)
+		{
+			add_rect(compositor, layer->drawn_x, layer->drawn_y,
+					layer->drawn_x + layer->canvas.width - 1, layer->drawn_y + layer->canvas.height - 1);
+		}
+		if (changed && layer->visible)
+		{
+			add_rect(compositor, layer->x, layer->y, layer->x + layer->canvas.width - 1, layer->y + layer->canvas.height - 1);
+		}
+		else if (layer->visible && layer->damaged)
+		{
+			add_rect(compositor, layer->x + layer->damage.x0, layer->y + layer->damage.y0,
+					layer->x + layer->damage.x1, layer->y + layer->damage.y1);
+		}
+
+		layer->damaged = 0;
+		layer->drawn = layer->visible;
+		layer->drawn_x = layer->x;
+		layer->drawn_y = layer->y;
+		layer->drawn_blend = layer->blend;
+		layer->drawn_key = layer->key;
+	}
+
+	uint8_t count = compositor->damage.count;
+	for (uint8_t i = 0; i < count; i++)
+	{
+		compose_rect(compositor, &compositor->damage.rects[i]);
+	}
+	if (upload)
+		send_damage_to_OLED(compositor->output, &compositor->damage);
+	damage_clear(&compositor->damage);
+	return count;
+}
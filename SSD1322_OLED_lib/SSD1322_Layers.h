@@ -0,0 +1,80 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Layers.h
+ *
+ * \brief Layers with own frame buffers composed into output canvas.
+ *
+ * Each layer (background, UI, popups...) is a separate 4bpp canvas with position, visibility
+ * and blend mode. Layers remember areas that were drawn on, so compositor merges and sends
+ * only damaged areas - hiding a popup restores what was under it without redrawing anything.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_LAYERS_H
+#define SSD1322_LAYERS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+
+/*============ defines ============*/
+
+#define LAYER_BLEND_OPAQUE   0    //layer covers everything below
+#define LAYER_BLEND_KEY      1    //pixels with key brightness are transparent
+#define LAYER_BLEND_ADD      2    //brightness is added to layers below, saturated at 15
+#define LAYER_BLEND_MAX      3    //brighter of layer and layers below is shown
+
+/*============ layer structures ============*/
+
+// Single layer
+typedef struct {
+  GFXcanvas canvas;      ///< Layer pixels, drawn with GFX functions
+  int16_t x;             ///< x position of top left corner on output, may be outside output
+  int16_t y;             ///< y position of top left corner on output, may be outside output
+  uint8_t visible;       ///< 1 if layer is composed
+  uint8_t blend;         ///< LAYER_BLEND_OPAQUE, LAYER_BLEND_KEY, LAYER_BLEND_ADD or LAYER_BLEND_MAX
+  uint8_t key;           ///< Transparent brightness for LAYER_BLEND_KEY
+  uint8_t damaged;       ///< 1 if damage rectangle is valid
+  GFXrect damage;        ///< Area changed since last composition, in layer frame buffer coordinates
+  int16_t drawn_x;       ///< x position at last composition
+  int16_t drawn_y;       ///< y position at last composition
+  uint8_t drawn;         ///< 1 if layer was visible at last composition
+  uint8_t drawn_blend;   ///< Blend mode at last composition
+  uint8_t drawn_key;     ///< Key at last composition
+} GFXlayer;
+
+// Layers stacked over output canvas
+typedef struct {
+  GFXcanvas *output;     ///< Canvas that layers are composed into
+  GFXlayer **layers;     ///< Layers from bottom to top
+  uint8_t count;         ///< Amount of layers
+  GFXdamage damage;      ///< Damaged areas in output coordinates
+} GFXcompositor;
+
+/*============ functions ============*/
+
+void layer_init(GFXlayer *layer, uint8_t *buffer, uint16_t width, uint16_t height, uint8_t blend);
+void layer_damage(GFXlayer *layer, const GFXrect *rect);
+void layer_damage_all(GFXlayer *layer);
+void layer_move(GFXlayer *layer, int16_t x, int16_t y);
+void layer_show(GFXlayer *layer, uint8_t visible);
+void layer_set_blend(GFXlayer *layer, uint8_t blend, uint8_t key);
+
+void compositor_init(GFXcompositor *compositor, GFXcanvas *output, GFXlayer **layers, uint8_t count);
+uint8_t compositor_update(GFXcompositor *compositor, uint8_t upload);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_LAYERS_H */
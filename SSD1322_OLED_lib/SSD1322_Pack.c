@@ -0,0 +1,428 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Pack.c
+ *
+ * \brief Binary pack of fonts and bitmaps used in place, without copying.
+ *
+ * Layout of pack:
+ *  - GFXpack_header,
+ *  - entry_count GFXpack_entry structures sorted by name,
+ *  - data blocks, each aligned to PACK_ALIGNMENT bytes.
+ *
+ * Structures are stored in memory layout of the target (little endian, natural alignment),
+ * so ARM MCUs and x86 or ARM hosts can build and read the same packs. Big endian targets
+ * are not supported, their packs are rejected by version check. Layout of structures is
+ * checked while compiling. Pack has to start at address aligned to PACK_ALIGNMENT. Opening
+ * a pack checks header, index and glyph tables, assets are found with binary search by name.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Pack.h"
+
+#include <stddef.h>
+#include <string.h>
+
+//====================== layout checks ========================//
+// Array of negative size fails compilation if compiler pads structures differently than the pack format
+#define PACK_LAYOUT_CHECK(name, condition) typedef char pack_layout_##name[(condition) ? 1 : -1]
+
+PACK_LAYOUT_CHECK(header_size, sizeof(GFXpack_header) == 12);
+PACK_LAYOUT_CHECK(header_version, offsetof(GFXpack_header, version) == 4);
+PACK_LAYOUT_CHECK(header_count, offsetof(GFXpack_header, entry_count) == 6);
+PACK_LAYOUT_CHECK(header_total, offsetof(GFXpack_header, size) == 8);
+PACK_LAYOUT_CHECK(entry_size, sizeof(GFXpack_entry) == 48);
+PACK_LAYOUT_CHECK(entry_type, offsetof(GFXpack_entry, type) == 16);
+PACK_LAYOUT_CHECK(entry_width, offsetof(GFXpack_entry, width) == 20);
+PACK_LAYOUT_CHECK(entry_glyph_count, offsetof(GFXpack_entry, glyph_count) == 28);
+PACK_LAYOUT_CHECK(entry_data, offsetof(GFXpack_entry, data) == 32);
+PACK_LAYOUT_CHECK(entry_codepoints, offsetof(GFXpack_entry, codepoints) == 44);
+PACK_LAYOUT_CHECK(glyph_size, sizeof(GFXglyph) == 8);
+PACK_LAYOUT_CHECK(glyph_offset, offsetof(GFXglyph, yOffset) == 6);
+
+//====================== bitmap size ========================//
+static uint32_t bitmap_size(uint16_t width, uint16_t height, uint8_t bpp)
+{
+	if (bpp == 8)
+		return (uint32_t)width * height;
+	if (bpp == 4)
+		return ((uint32_t)width * height + 1) / 2;
+	return 0;
+}
+
+//====================== check block ========================//
+/**
+ *  @brief Checks if data block lies inside pack and is aligned.
+ */
+static uint8_t block_valid(uint32_t offset, uint32_t size, uint32_t pack_size)
+{
+	return offset % PACK_ALIGNMENT == 0 && offset <= pack_size && size <= pack_size - offset;
+}
+
+//====================== open pack ========================//
+/**
+ *  @brief Checks pack header and index.
+ *
+ *  Data of assets is not copied, pack memory has to stay valid while pack is used.
+ *
+ *  @param[out] pack
+ *             pack to open
+ *  @param[in] data
+ *             beginning of pack, aligned to PACK_ALIGNMENT
+ *  @param[in] size
+ *             amount of available bytes
+ *
+ *  @return 1 if pack is valid, 0 otherwise
+ */
+uint8_t pack_open(GFXpack *pack, const void *data, uint32_t size)
+{
+	const GFXpack_header *header = data;
+
+	if (data == NULL || (uintptr_t)data % PACK_ALIGNMENT != 0 || size < sizeof(GFXpack_header))
+		return 0;
+	if (memcmp(header->magic, "SPAK", 4) != 0 || header->version != PACK_VERSION || header->size > size
+			|| header->size < PACK_INDEX_SIZE(header->entry_count))
+		return 0;
+
+	pack->data = data;
+	pack->header = header;
+	pack->entries = (const GFXpack_entry *)(pack->data + sizeof(GFXpack_header));
+
+	for (uint16_t i = 0; i < header->entry_count; i++)
+	{
+		const GFXpack_entry *entry = &pack->entries[i];
+
+		if (entry->name[PACK_NAME_LENGTH - 1] != '\0' || !block_valid(entry->data, entry->data_size, header->size))
+			return 0;
+		if (entry->type == PACK_BITMAP)
+		{
+			if (bitmap_size(entry->width, entry->height, entry->bpp) == 0
+					|| entry->data_size < bitmap_size(entry->width, entry->height, entry->bpp))
+				return 0;
+		}
+		else if (entry->type == PACK_FONT)
+		{
+			if (entry->glyph_count == 0 || !block_valid(entry->glyphs, (uint32_t)entry->glyph_count * sizeof(GFXglyph), header->size))
+				return 0;
+			if (entry->codepoints != 0 && !block_valid(entry->codepoints, (uint32_t)entry->glyph_count * sizeof(uint16_t), header->size))
+				return 0;
+			if (entry->codepoints == 0 && entry->glyph_count != entry->last - entry->first + 1)
+				return 0;
+
+			//glyph bitmaps are read without further checks when text is drawn
+			const GFXglyph *glyphs = (const GFXglyph *)(pack->data + entry->glyphs);
+			for (uint16_t j = 0; j < entry->glyph_count; j++)
+			{
+				if (glyphs[j].bitmapOffset + ((uint32_t)glyphs[j].width * glyphs[j].height + 7) / 8 > entry->data_size)
+					return 0;
+			}
+		}
+		else
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+//====================== find asset ========================//
+/**
+ *  @brief Finds asset in pack by name.
+ *
+ *  @return pointer to index entry or NULL if there is no such asset
+ */
+const GFXpack_entry *pack_find(const GFXpack *pack, const char *name)
+{
+	uint16_t low = 0;
+	uint16_t high = pack->header->entry_count;
+
+	while (low < high)
+	{
+		uint16_t middle = (low + high) / 2;
+		int result = strncmp(pack->entries[middle].name, name, PACK_NAME_LENGTH);
+		if (result == 0)
+			return &pack->entries[middle];
+		if (result < 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return NULL;
+}
+
+//====================== asset data ========================//
+/**
+ *  @brief Returns pointer to pixels of bitmap or glyph bitmaps of font.
+ */
+const uint8_t *pack_data(const GFXpack *pack, const GFXpack_entry *entry)
+{
+	return pack->data + entry->data;
+}
+
+//====================== font from pack ========================//
+/**
+ *  @brief Prepares font that uses glyphs stored in pack
+ *
+ *  Only pointers are set, glyph tables and bitmaps stay in pack.
+ *
+ *  @param[in] pack
+ *             opened pack
+ *  @param[in] name
+ *             name of font
+ *  @param[out] font
+ *             font to prepare, can be selected with select_font() afterwards
+ *
+ *  @return 1 on success, 0 if there is no such font
+ */
+uint8_t pack_font(const GFXpack *pack, const char *name, GFXfont *font)
+{
+	const GFXpack_entry *entry = pack_find(pack, name);
+
+	if (entry == NULL || entry->type != PACK_FONT)
+		return 0;
+
+	font->bitmap = (uint8_t *)(pack->data + entry->data);
+	font->glyph = (GFXglyph *)(pack->data + entry->glyphs);
+	font->first = entry->first;
+	font->last = entry->last;
+	font->yAdvance = entry->y_advance;
+	font->codepoints = entry->codepoints ? (const uint16_t *)(pack->data + entry->codepoints) : NULL;
+	font->glyph_count = entry->codepoints ? entry->glyph_count : 0;
+	font->load_bitmap = NULL;
+	font->loader = NULL;
+	return 1;
+}
+
+//====================== draw bitmap from pack ========================//
+/**
+ *  @brief Draws bitmap stored in pack
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] pack
+ *             opened pack
+ *  @param[in] name
+ *             name of bitmap
+ *  @param[in] x0
+ *             x position of top left bitmap corner
+ *  @param[in] y0
+ *             y position of top left bitmap corner
+ *
+ *  @return 1 on success, 0 if there is no such bitmap
+ */
+uint8_t draw_pack_bitmap(GFXcanvas *canvas, const GFXpack *pack, const char *name, uint16_t x0, uint16_t y0)
+{
+	const GFXpack_entry *entry = pack_find(pack, name);
+
+	if (entry == NULL || entry->type != PACK_BITMAP)
+		return 0;
+
+	if (entry->bpp == 8)
+		draw_bitmap_8bpp(canvas, pack->data + entry->data, x0, y0, entry->width, entry->height);
+	else
+		draw_bitmap_4bpp(canvas, pack->data + entry->data, x0, y0, entry->width, entry->height);
+	return 1;
+}
+
+//====================== begin building ========================//
+/**
+ *  @brief Starts building a pack in memory
+ *
+ *  Pack can be built on PC and saved to file, or on MCU and written to external flash.
+ *
+ *  @param[in] builder
+ *             builder state
+ *  @param[in] buffer
+ *             output memory
+ *  @param[in] capacity
+ *             size of output memory in bytes
+ *  @param[in] entry_count
+ *             amount of assets that will be added
+ */
+void pack_build_begin(GFXpack_builder *builder, uint8_t *buffer, uint32_t capacity, uint16_t entry_count)
+{
+	builder->buffer = buffer;
+	builder->capacity = capacity;
+	builder->entry_count = entry_count;
+	builder->used = 0;
+	builder->size = PACK_INDEX_SIZE(entry_count);
+	builder->error = builder->size > capacity;
+	if (!builder->error)
+		memset(buffer, 0, builder->size);
+}
+
+//====================== append data block ========================//
+/**
+ *  @brief Copies data block to the end of pack.
+ *
+ *  @return offset of block or 0 if it does not fit
+ */
+static uint32_t append_block(GFXpack_builder *builder, const void *data, uint32_t size)
+{
+	uint32_t offset = (builder->size + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+
+	if (offset > builder->capacity || size > builder->capacity - offset)
+	{
+		builder->error = 1;
+		return 0;
+	}
+	memset(builder->buffer + builder->size, 0, offset - builder->size);
+	memcpy(builder->buffer + offset, data, size);
+	builder->size = offset + size;
+	return offset;
+}
+
+//====================== add index entry ========================//
+static uint8_t add_entry(GFXpack_builder *builder, GFXpack_entry *entry, const char *name)
+{
+	if (builder->error || builder->used >= builder->entry_count || strlen(name) >= PACK_NAME_LENGTH)
+	{
+		builder->error = 1;
+		return 0;
+	}
+	memset(entry->name, 0, PACK_NAME_LENGTH);
+	strcpy(entry->name, name);
+	memcpy(builder->buffer + PACK_INDEX_SIZE(builder->used), entry, sizeof(GFXpack_entry));
+	builder->used++;
+	return 1;
+}
+
+//====================== add bitmap ========================//
+/**
+ *  @brief Adds 4 or 8 bits per pixel bitmap to pack
+ *
+ *  @param[in] builder
+ *             builder state
+ *  @param[in] name
+ *             unique name, up to PACK_NAME_LENGTH - 1 characters
+ *  @param[in] bitmap
+ *             pixels in format of draw_bitmap_4bpp() or draw_bitmap_8bpp()
+ *  @param[in] width
+ *             width of bitmap in pixels
+ *  @param[in] height
+ *             height of bitmap in pixels
+ *  @param[in] bpp
+ *             4 or 8
+ *
+ *  @return 1 on success, 0 if bitmap does not fit or is invalid
+ */
+uint8_t pack_add_bitmap(GFXpack_builder *builder, const char *name, const uint8_t *bitmap, uint16_t width, uint16_t height, uint8_t bpp)
+{
+	GFXpack_entry entry;
+	uint32_t size = bitmap_size(width, height, bpp);
+
+	memset(&entry, 0, sizeof(entry));
+	if (size == 0)
+	{
+		builder->error = 1;
+		return 0;
+	}
+	entry.type = PACK_BITMAP;
+	entry.bpp = bpp;
+	entry.width = width;
+	entry.height = height;
+	entry.data_size = size;
+	entry.data = append_block(builder, bitmap, size);
+	return add_entry(builder, &entry, name);
+}
+
+//====================== add font ========================//
+/**
+ *  @brief Adds font to pack
+ *
+ *  Contiguous and sparse fonts can be added. Fonts attached to SSD1322_Cache can not.
+ *
+ *  @param[in] builder
+ *             builder state
+ *  @param[in] name
+ *             unique name, up to PACK_NAME_LENGTH - 1 characters
+ *  @param[in] font
+ *             font to copy into pack
+ *
+ *  @return 1 on success, 0 if font does not fit or is invalid
+ */
+uint8_t pack_add_font(GFXpack_builder *builder, const char *name, const GFXfont *font)
+{
+	GFXpack_entry entry;
+	uint16_t glyph_count = font->codepoints ? font->glyph_count : font->last - font->first + 1;
+	uint32_t bitmap_bytes = 0;
+
+	memset(&entry, 0, sizeof(entry));
+	if (font->load_bitmap != NULL || font->last < font->first || glyph_count == 0)
+	{
+		builder->error = 1;
+		return 0;
+	}
+
+	//glyph bitmaps are concatenated, their size is given by the furthest glyph
+	for (uint16_t i = 0; i < glyph_count; i++)
+	{
+		const GFXglyph *glyph = &font->glyph[i];
+		uint32_t end = glyph->bitmapOffset + ((uint32_t)glyph->width * glyph->height + 7) / 8;
+		if (end > bitmap_bytes)
+			bitmap_bytes = end;
+	}
+
+	entry.type = PACK_FONT;
+	entry.y_advance = font->yAdvance;
+	entry.first = font->first;
+	entry.last = font->last;
+	entry.glyph_count = glyph_count;
+	entry.glyphs = append_block(builder, font->glyph, (uint32_t)glyph_count * sizeof(GFXglyph));
+	if (font->codepoints != NULL)
+		entry.codepoints = append_block(builder, font->codepoints, (uint32_t)glyph_count * sizeof(uint16_t));
+	entry.data_size = bitmap_bytes;
+	entry.data = append_block(builder, font->bitmap, bitmap_bytes);
+	return add_entry(builder, &entry, name);
+}
+
+//====================== finish building ========================//
+/**
+ *  @brief Sorts index and writes header
+ *
+ *  @param[in] builder
+ *             builder state
+ *
+ *  @return size of pack in bytes, 0 if anything failed, not all entries were added or names repeat
+ */
+uint32_t pack_build_end(GFXpack_builder *builder)
+{
+	GFXpack_header header;
+	GFXpack_entry a, b;
+
+	if (builder->error || builder->used != builder->entry_count)
+		return 0;
+
+	//insertion sort, index is small and entries may be unaligned in the buffer
+	for (uint16_t i = 1; i < builder->entry_count; i++)
+	{
+		memcpy(&a, builder->buffer + PACK_INDEX_SIZE(i), sizeof(a));
+		uint16_t j = i;
+		while (j > 0)
+		{
+			memcpy(&b, builder->buffer + PACK_INDEX_SIZE(j - 1), sizeof(b));
+			int result = strncmp(b.name, a.name, PACK_NAME_LENGTH);
+			if (result == 0)
+				return 0;
+			if (result < 0)
+				break;
+			memcpy(builder->buffer + PACK_INDEX_SIZE(j), &b, sizeof(b));
+			j--;
+		}
+		memcpy(builder->buffer + PACK_INDEX_SIZE(j), &a, sizeof(a));
+	}
+
+	memcpy(header.magic, "SPAK", 4);
+	header.version = PACK_VERSION;
+	header.entry_count = builder->entry_count;
+	header.size = builder->size;
+	memcpy(builder->buffer, &header, sizeof(header));
+	return builder->size;
+}
@@ -0,0 +1,108 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Pack.h
+ *
+ * \brief Binary pack of fonts and bitmaps used in place, without copying.
+ *
+ * Pack is a single block of memory with an index of named assets followed by their data.
+ * It can be linked into flash, read from memory mapped external flash or mmap()'ed file.
+ * Glyph tables, codepoints and pixels are used straight from the pack.
+ *
+ * All numbers are little endian and structures have natural alignment - the layout used
+ * by GCC for ARM Cortex-M and for x86 and ARM hosts.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_PACK_H
+#define SSD1322_PACK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+
+/*============ defines ============*/
+
+#define PACK_VERSION     1
+#define PACK_NAME_LENGTH 16    ///< Including terminating zero
+#define PACK_ALIGNMENT   4     ///< Every data block starts at multiple of this offset
+
+#define PACK_BITMAP 1          ///< 4 or 8 bits per pixel bitmap, same format as draw_bitmap_4bpp() and draw_bitmap_8bpp()
+#define PACK_FONT   2          ///< Font with glyph table, optional codepoints and glyph bitmaps
+
+// Size of pack header and index with given amount of entries
+#define PACK_INDEX_SIZE(entry_count)  (sizeof(GFXpack_header) + (uint32_t)(entry_count) * sizeof(GFXpack_entry))
+
+/*============ pack structures ============*/
+
+// Beginning of pack
+typedef struct {
+  char magic[4];           ///< "SPAK"
+  uint16_t version;        ///< PACK_VERSION
+  uint16_t entry_count;    ///< Amount of entries in index
+  uint32_t size;           ///< Size of whole pack in bytes
+} GFXpack_header;
+
+// Index entry, entries are sorted by name. Offsets are counted from the beginning of pack.
+typedef struct {
+  char name[PACK_NAME_LENGTH]; ///< Zero terminated name of asset
+  uint8_t type;            ///< PACK_BITMAP or PACK_FONT
+  uint8_t bpp;             ///< Bitmap only: bits per pixel
+  uint8_t y_advance;       ///< Font only: newline distance
+  uint8_t reserved;
+  uint16_t width;          ///< Bitmap only: width in pixels
+  uint16_t height;         ///< Bitmap only: height in pixels
+  uint16_t first;          ///< Font only: lowest codepoint
+  uint16_t last;           ///< Font only: highest codepoint
+  uint16_t glyph_count;    ///< Font only: amount of glyphs
+  uint16_t reserved2;
+  uint32_t data;           ///< Offset of pixels or glyph bitmaps
+  uint32_t data_size;      ///< Size of pixels or glyph bitmaps in bytes
+  uint32_t glyphs;         ///< Font only: offset of GFXglyph table
+  uint32_t codepoints;     ///< Font only: offset of sorted codepoints, 0 for contiguous fonts
+} GFXpack_entry;
+
+// Opened pack
+typedef struct {
+  const uint8_t *data;             ///< Beginning of pack
+  const GFXpack_header *header;    ///< Header at the beginning of pack
+  const GFXpack_entry *entries;    ///< Index following the header
+} GFXpack;
+
+// State of pack being built
+typedef struct {
+  uint8_t *buffer;         ///< Output
+  uint32_t capacity;       ///< Size of output in bytes
+  uint32_t size;           ///< Bytes used so far
+  uint16_t entry_count;    ///< Entries reserved in index
+  uint16_t used;           ///< Entries added so far
+  uint8_t error;           ///< Set when anything did not fit or was invalid
+} GFXpack_builder;
+
+/*============ functions ============*/
+
+uint8_t pack_open(GFXpack *pack, const void *data, uint32_t size);
+const GFXpack_entry *pack_find(const GFXpack *pack, const char *name);
+const uint8_t *pack_data(const GFXpack *pack, const GFXpack_entry *entry);
+uint8_t pack_font(const GFXpack *pack, const char *name, GFXfont *font);
+uint8_t draw_pack_bitmap(GFXcanvas *canvas, const GFXpack *pack, const char *name, uint16_t x0, uint16_t y0);
+
+void pack_build_begin(GFXpack_builder *builder, uint8_t *buffer, uint32_t capacity, uint16_t entry_count);
+uint8_t pack_add_bitmap(GFXpack_builder *builder, const char *name, const uint8_t *bitmap, uint16_t width, uint16_t height, uint8_t bpp);
+uint8_t pack_add_font(GFXpack_builder *builder, const char *name, const GFXfont *font);
+uint32_t pack_build_end(GFXpack_builder *builder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_PACK_H */
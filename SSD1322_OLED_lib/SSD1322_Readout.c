@@ -0,0 +1,247 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Readout.c
+ *
+ * \brief Fast numeric readout with pre-rendered digits, for values updated very often.
+ *
+ * Cells are a multiple of 4 pixels wide, so a cell placed at x divisible by 4 covers whole
+ * SSD1322 columns and sending it does not resend any pixel of its neighbours. Copying a cell
+ * is one memcpy per row. Neighbouring changed cells are sent as one window.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Widgets.h"
+#include "../SSD1322_OLED_lib/SSD1322_Readout.h"
+
+#include <string.h>
+
+#define GLYPH_MINUS  10
+#define GLYPH_POINT  11
+#define GLYPH_BLANK  12
+
+static const char glyph_chars[READOUT_GLYPHS] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '-', '.', ' ' };
+
+//====================== cell size ========================//
+/**
+ *  @brief Computes size of a cell that fits every digit, minus sign and decimal point of a font.
+ *
+ *  @param[in] font
+ *             font of readout
+ *  @param[out] cell_width
+ *             widest cursor advance rounded up to multiple of 4
+ *  @param[out] cell_height
+ *             height of font from font_extent()
+ */
+void readout_cell_size(const GFXfont *font, uint8_t *cell_width, uint8_t *cell_height)
+{
+	GFXcanvas measure;
+	GFXtext_metrics metrics;
+	uint8_t ascent, descent;
+	uint16_t width = 0;
+	char text[2] = { 0, 0 };
+
+	canvas_init(&measure, NULL, 0, 0);
+	select_font(&measure, font);
+	for (uint8_t i = 0; i < GLYPH_BLANK; i++)
+	{
+		text[0] = glyph_chars[i];
+		measure_text(&measure, text, &metrics);
+		if (metrics.advance > width)
+			width = metrics.advance;
+		if (metrics.x + metrics.width > width)
+			width = metrics.x + metrics.width;
+	}
+	font_extent(font, &ascent, &descent);
+
+	*cell_width = (width + 3) & ~3;
+	*cell_height = ascent + descent;
+}
+
+//====================== init readout ========================//
+/**
+ *  @brief Pre-renders cells and prepares readout. Value is drawn on first readout_set().
+ *
+ *  Readout works in frame buffer coordinates, rotation and clipping of canvas are not used.
+ *  Cells that do not fit in canvas are dropped.
+ *
+ *  @param[in] readout
+ *             readout to prepare
+ *  @param[in] canvas
+ *             canvas that readout is drawn on
+ *  @param[in] font
+ *             font of digits
+ *  @param[in] x
+ *             x position of top left corner, even (divisible by 4 for the fastest sending)
+ *  @param[in] y
+ *             y position of top left corner
+ *  @param[in] cells
+ *             amount of character cells, up to READOUT_MAX_CELLS
+ *  @param[in] decimals
+ *             digits after decimal point, value 1234 with 2 decimals is shown as 12.34
+ *  @param[in] brightness
+ *             brightness of digits
+ *  @param[in] background
+ *             brightness of background
+ *  @param[in] work
+ *             array of READOUT_WORK_SIZE(cell_width, cell_height) bytes that has to stay valid
+ *             as long as readout is used, cell size is given by readout_cell_size()
+ */
+void readout_init(GFXreadout *readout, GFXcanvas *canvas, const GFXfont *font, uint16_t x, uint16_t y, uint8_t cells,
+		uint8_t decimals, uint8_t brightness, uint8_t background, uint8_t *work)
+{
+	GFXcanvas cell;
+	GFXtext_metrics metrics;
+	uint8_t ascent, descent;
+	char text[2] = { 0, 0 };
+
+	readout_cell_size(font, &readout->cell_width, &readout->cell_height);
+	font_extent(font, &ascent, &descent);
+
+	if (cells > READOUT_MAX_CELLS)
+		cells = READOUT_MAX_CELLS;
+	x &= ~1;
+	if (x + (uint32_t)cells * readout->cell_width > canvas->width)
+		cells = x < canvas->width ? (canvas->width - x) / readout->cell_width : 0;
+
+	readout->canvas = canvas;
+	readout->x = x;
+	readout->y = y;
+	readout->cells = cells;
+	readout->decimals = decimals;
+	readout->glyphs = work;
+	readout->drawn = 0;
+	readout->value = 0;
+
+	//each glyph is a small canvas with character centered horizontally
+	uint32_t glyph_size = (uint32_t)readout->cell_width / 2 * readout->cell_height;
+	for (uint8_t i = 0; i < READOUT_GLYPHS; i++)
+	{
+		canvas_init(&cell, work + i * glyph_size, readout->cell_width, readout->cell_height);
+		select_font(&cell, font);
+		fill_buffer(&cell, background);
+		if (i == GLYPH_BLANK)
+			continue;
+
+		text[0] = glyph_chars[i];
+		measure_text(&cell, text, &metrics);
+		draw_char(&cell, glyph_chars[i], (readout->cell_width - metrics.advance) / 2, ascent, brightness);
+	}
+}
+
+//====================== glyph of character ========================//
+static uint8_t glyph_index(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c == '-')
+		return GLYPH_MINUS;
+	if (c == '.')
+		return GLYPH_POINT;
+	return GLYPH_BLANK;
+}
+
+//====================== copy cell ========================//
+/**
+ *  @brief Copies pre-rendered glyph into frame buffer, one memcpy per row.
+ */
+static void put_cell(GFXreadout *readout, uint8_t cell, uint8_t glyph)
+{
+	GFXcanvas *canvas = readout->canvas;
+	uint16_t row_bytes = readout->cell_width / 2;
+	const uint8_t *src = readout->glyphs + (uint32_t)glyph * row_bytes * readout->cell_height;
+	uint8_t *dst = canvas->buffer + (uint32_t)readout->y * canvas->stride + (readout->x + cell * readout->cell_width) / 2;
+
+	for (uint16_t row = 0; row < readout->cell_height && readout->y + row < canvas->height; row++)
+	{
+		memcpy(dst, src, row_bytes);
+		src += row_bytes;
+		dst += canvas->stride;
+	}
+}
+
+//====================== send changed cells ========================//
+/**
+ *  @brief Adds cells first..last to damage list or sends them right away.
+ */
+static void flush_cells(GFXreadout *readout, GFXdamage *damage, uint8_t first, uint8_t last)
+{
+	GFXrect rect;
+	rect.x0 = readout->x + first * readout->cell_width;
+	rect.x1 = readout->x + (last + 1) * readout->cell_width - 1;
+	rect.y0 = readout->y;
+	rect.y1 = readout->y + readout->cell_height - 1;
+	if (rect.y1 > readout->canvas->height - 1)
+		rect.y1 = readout->canvas->height - 1;
+
+	if (damage != NULL)
+		damage_add(damage, &rect);
+	else
+		send_rect_to_OLED(readout->canvas, rect.x0, rect.y0, rect.x1, rect.y1);
+}
+
+//====================== set readout value ========================//
+/**
+ *  @brief Shows new value. Only cells whose character has changed are copied and sent.
+ *
+ *  Number is aligned to the right cell, cells on the left are blank. Number that does
+ *  not fit in readout is shown as minus signs in all cells.
+ *
+ *  @param[in] readout
+ *             readout to update
+ *  @param[in,out] damage
+ *             list that changed cells are added to, NULL to send them to OLED right away
+ *  @param[in] value
+ *             new value as integer, decimal point is placed according to readout->decimals
+ *
+ *  @return amount of changed cells
+ */
+uint8_t readout_set(GFXreadout *readout, GFXdamage *damage, int32_t value)
+{
+	char text[WIDGET_NUMBER_TEXT_SIZE];
+	uint8_t length, changed = 0;
+	int16_t first = -1;
+
+	if (readout->drawn && readout->value == value)
+		return 0;
+
+	length = format_fixed(value, readout->decimals, text);
+
+	for (uint8_t i = 0; i < readout->cells; i++)
+	{
+		int16_t j = i - (readout->cells - length);
+		uint8_t glyph;
+
+		if (length > readout->cells)
+			glyph = GLYPH_MINUS;
+		else
+			glyph = j < 0 ? GLYPH_BLANK : glyph_index(text[j]);
+
+		if (!readout->drawn || glyph != readout->shown[i])
+		{
+			put_cell(readout, i, glyph);
+			readout->shown[i] = glyph;
+			changed++;
+			if (first < 0)
+				first = i;
+		}
+		else if (first >= 0)
+		{
+			flush_cells(readout, damage, first, i - 1);
+			first = -1;
+		}
+	}
+	if (first >= 0)
+		flush_cells(readout, damage, first, readout->cells - 1);
+
+	readout->value = value;
+	readout->drawn = 1;
+	return changed;
+}
@@ -0,0 +1,66 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Readout.h
+ *
+ * \brief Fast numeric readout with pre-rendered digits, for values updated very often.
+ *
+ * Digits, minus sign and decimal point are rendered once into cells of equal width.
+ * Setting a value formats it without printf, copies pre-rendered cells only in place
+ * of characters that have changed and sends only these cells to OLED.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_READOUT_H
+#define SSD1322_READOUT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Widgets.h"
+
+/*============ defines ============*/
+
+#define READOUT_GLYPHS     13                               //digits 0-9, minus, decimal point and blank cell
+#define READOUT_MAX_CELLS  (WIDGET_NUMBER_TEXT_SIZE - 1)    //enough for any int32_t with sign and decimal point
+
+// Size of work array for pre-rendered cells, cell size is given by readout_cell_size()
+#define READOUT_WORK_SIZE(cell_width, cell_height)  (READOUT_GLYPHS * ((cell_width) / 2) * (cell_height))
+
+/*============ readout structure ============*/
+
+typedef struct {
+  GFXcanvas *canvas;        ///< Canvas that readout is drawn on
+  uint16_t x;               ///< x position of top left corner in frame buffer coordinates, even
+  uint16_t y;               ///< y position of top left corner in frame buffer coordinates
+  uint8_t cell_width;       ///< Width of a character cell in pixels, multiple of 4
+  uint8_t cell_height;      ///< Height of a character cell in pixels
+  uint8_t cells;            ///< Amount of cells, number is aligned to the right one
+  uint8_t decimals;         ///< Digits after decimal point
+  uint8_t *glyphs;          ///< Pre-rendered cells in frame buffer format, READOUT_GLYPHS of them
+  uint8_t drawn;            ///< 1 if cells below are displayed, clear to force redraw
+  int32_t value;            ///< Displayed value
+  uint8_t shown[READOUT_MAX_CELLS];   ///< Displayed glyph of each cell
+} GFXreadout;
+
+/*============ functions ============*/
+
+void readout_cell_size(const GFXfont *font, uint8_t *cell_width, uint8_t *cell_height);
+void readout_init(GFXreadout *readout, GFXcanvas *canvas, const GFXfont *font, uint16_t x, uint16_t y, uint8_t cells,
+		uint8_t decimals, uint8_t brightness, uint8_t background, uint8_t *work);
+uint8_t readout_set(GFXreadout *readout, GFXdamage *damage, int32_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_READOUT_H */
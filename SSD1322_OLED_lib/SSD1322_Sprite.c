@@ -0,0 +1,303 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Sprite.c
+ *
+ * \brief Sprite layer composed over background picture line by line.
+ *
+ * Sprite pixels and masks are shifted by one nibble for odd x positions when sprite is loaded,
+ * so composing a line needs only one AND and one OR per frame buffer byte.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_API.h"
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Sprite.h"
+
+#include <string.h>
+
+//====================== load sprite ========================//
+/**
+ *  @brief Prepares sprite from 4 bits per pixel bitmap.
+ *
+ *  Bitmap format is the same as for draw_bitmap_4bpp(). Pixels and masks for both
+ *  even and odd x positions are computed once here and stored in work array.
+ *  Sprite is placed at (0, 0) and hidden.
+ *
+ *  @param[in] sprite
+ *             sprite to prepare
+ *  @param[in] bitmap
+ *             4 bits per pixel bitmap
+ *  @param[in] width
+ *             width of bitmap in pixels
+ *  @param[in] height
+ *             height of bitmap in pixels
+ *  @param[in] transparent
+ *             brightness value (0-15) that is not drawn
+ *  @param[in] work
+ *             array of SPRITE_WORK_SIZE(width, height) bytes that has to stay valid as long as sprite is used
+ */
+void sprite_load(GFXsprite *sprite, const uint8_t *bitmap, uint16_t width, uint16_t height, uint8_t transparent, uint8_t *work)
+{
+	uint16_t row_bytes = width / 2 + 1;
+	uint32_t plane_size = (uint32_t)row_bytes * height;
+
+	sprite->width = width;
+	sprite->height = height;
+	sprite->row_bytes = row_bytes;
+	sprite->data[0] = work;
+	sprite->data[1] = work + plane_size;
+	sprite->mask[0] = work + 2 * plane_size;
+	sprite->mask[1] = work + 3 * plane_size;
+	sprite->x = 0;
+	sprite->y = 0;
+	sprite->z = 0;
+	sprite->visible = 0;
+	sprite->drawn = 0;
+
+	memset(sprite->data[0], 0x00, 2 * plane_size);
+	memset(sprite->mask[0], 0xFF, 2 * plane_size);
+
+	uint32_t pixel = 0;
+	for (uint16_t i = 0; i < height; i++)
+	{
+		for (uint16_t j = 0; j < width; j++)
+		{
+			uint8_t value = (pixel % 2 == 0) ? bitmap[pixel / 2] >> 4 : bitmap[pixel / 2] & 0x0F;
+			pixel++;
+			if (value == transparent)
+				continue;
+
+			for (uint8_t parity = 0; parity < 2; parity++)
+			{
+				uint16_t pos = j + parity;
+				uint32_t byte = (uint32_t)i * row_bytes + pos / 2;
+				if (pos % 2 == 0)
+				{
+					sprite->data[parity][byte] |= value << 4;
+					sprite->mask[parity][byte] &= 0x0F;
+				}
+				else
+				{
+					sprite->data[parity][byte] |= value;
+					sprite->mask[parity][byte] &= 0xF0;
+				}
+			}
+		}
+	}
+}
+
+//====================== move sprite ========================//
+/**
+ *  @brief Sets new sprite position. Takes effect on next sprite_layer_update().
+ */
+void sprite_move(GFXsprite *sprite, int16_t x, int16_t y)
+{
+	sprite->x = x;
+	sprite->y = y;
+}
+
+//====================== show/hide sprite ========================//
+/**
+ *  @brief Shows (1) or hides (0) sprite. Takes effect on next sprite_layer_update().
+ */
+void sprite_show(GFXsprite *sprite, uint8_t visible)
+{
+	sprite->visible = visible;
+}
+
+//====================== clip area to frame buffer ========================//
+/**
+ *  @brief Clips area to frame buffer and widens it to whole bytes.
+ *
+ *  @return 0 if area is completely outside frame buffer
+ */
+static uint8_t clip_area(const GFXcanvas *canvas, int32_t x0, int32_t y0, int32_t x1, int32_t y1, GFXrect *rect)
+{
+	int32_t width = canvas->width;
+	int32_t height = canvas->height;
+
+	if (x0 < 0)
+		x0 = 0;
+	if (y0 < 0)
+		y0 = 0;
+	if (x1 > width - 1)
+		x1 = width - 1;
+	if (y1 > height - 1)
+		y1 = height - 1;
+	if (x0 > x1 || y0 > y1)
+		return 0;
+
+	rect->x0 = x0 & ~1;
+	rect->y0 = y0;
+	rect->x1 = x1 | 1;
+	rect->y1 = y1;
+	return 1;
+}
+
+//====================== compose area ========================//
+/**
+ *  @brief Composes background and visible sprites in given area, line by line.
+ *
+ *  Area has to start at even and end at odd x position.
+ */
+static void compose_area(GFXsprite_layer *layer, const GFXrect *rect)
+{
+	uint16_t stride = layer->canvas->stride;
+	int32_t b0 = rect->x0 / 2;
+	int32_t b1 = rect->x1 / 2;
+
+	for (uint16_t y = rect->y0; y <= rect->y1; y++)
+	{
+		uint8_t *line = layer->canvas->buffer + y * stride;
+
+		if (layer->background)
+			memcpy(line + b0, layer->background + y * stride + b0, b1 - b0 + 1);
+		else
+			memset(line + b0, 0x00, b1 - b0 + 1);
+
+		for (uint8_t i = 0; i < layer->count; i++)
+		{
+			GFXsprite *sprite = layer->sprites[i];
+			if (!sprite->visible || y < sprite->y || y >= sprite->y + sprite->height)
+				continue;
+
+			uint8_t parity = sprite->x & 1;
+			int32_t first = (sprite->x - parity) / 2;                //frame buffer byte of first sprite byte
+			int32_t start = first > b0 ? first : b0;
+			int32_t end = first + sprite->row_bytes - 1;
+			if (end > b1)
+				end = b1;
+			if (start > end)
+				continue;
+
+			uint32_t offset = (uint32_t)(y - sprite->y) * sprite->row_bytes + (start - first);
+			const uint8_t *data = sprite->data[parity] + offset;
+			const uint8_t *mask = sprite->mask[parity] + offset;
+			for (int32_t b = start; b <= end; b++)
+			{
+				line[b] = (line[b] & *mask++) | *data++;
+			}
+		}
+	}
+}
+
+//====================== init sprite layer ========================//
+/**
+ *  @brief Prepares sprite layer.
+ *
+ *  Sprites array is sorted by z, so z values have to be set before this call.
+ *  Layer is not drawn, call sprite_layer_redraw() to compose whole frame buffer.
+ *
+ *  @param[in] layer
+ *             layer to prepare
+ *  @param[in] canvas
+ *             canvas with frame buffer that layer is composed into, its rotation and clipping are not used
+ *  @param[in] background
+ *             picture with the same size and stride as frame buffer drawn under sprites or NULL for black background
+ *  @param[in] sprites
+ *             array of pointers to loaded sprites
+ *  @param[in] count
+ *             amount of sprites
+ */
+void sprite_layer_init(GFXsprite_layer *layer, GFXcanvas *canvas, const uint8_t *background, GFXsprite **sprites, uint8_t count)
+{
+	layer->sprites = sprites;
+	layer->count = count;
+	layer->canvas = canvas;
+	layer->background = background;
+
+	//insertion sort keeps order of sprites with equal z
+	for (uint8_t i = 1; i < count; i++)
+	{
+		GFXsprite *sprite = sprites[i];
+		uint8_t j = i;
+		while (j > 0 && sprites[j - 1]->z > sprite->z)
+		{
+			sprites[j] = sprites[j - 1];
+			j--;
+		}
+		sprites[j] = sprite;
+	}
+}
+
+//====================== redraw sprite layer ========================//
+/**
+ *  @brief Composes whole frame buffer without sending it to OLED.
+ *
+ *  @param[in] layer
+ *             sprite layer
+ */
+void sprite_layer_redraw(GFXsprite_layer *layer)
+{
+	GFXrect rect;
+	if (!clip_area(layer->canvas, 0, 0, layer->canvas->width - 1, layer->canvas->height - 1, &rect))
+		return;
+
+	compose_area(layer, &rect);
+	for (uint8_t i = 0; i < layer->count; i++)
+	{
+		GFXsprite *sprite = layer->sprites[i];
+		sprite->drawn = sprite->visible;
+		sprite->drawn_x = sprite->x;
+		sprite->drawn_y = sprite->y;
+	}
+}
+
+//====================== update sprite layer ========================//
+/**
+ *  @brief Redraws and sends to OLED areas of sprites that were moved, shown or hidden.
+ *
+ *  For every changed sprite only rectangle covering its old and new position is composed again
+ *  and sent with send_rect_to_OLED().
+ *
+ *  @param[in] layer
+ *             sprite layer
+ */
+void sprite_layer_update(GFXsprite_layer *layer)
+{
+	for (uint8_t i = 0; i < layer->count; i++)
+	{
+		GFXsprite *sprite = layer->sprites[i];
+
+		if (sprite->visible == sprite->drawn && (!sprite->visible || (sprite->x == sprite->drawn_x && sprite->y == sprite->drawn_y)))
+			continue;
+
+		int32_t x0 = INT16_MAX, y0 = INT16_MAX, x1 = INT16_MIN, y1 = INT16_MIN;
+		if (sprite->drawn)
+		{
+			x0 = sprite->drawn_x;
+			y0 = sprite->drawn_y;
+			x1 = sprite->drawn_x + sprite->width - 1;
+			y1 = sprite->drawn_y + sprite->height - 1;
+		}
+		if (sprite->visible)
+		{
+			if (sprite->x < x0)
+				x0 = sprite->x;
+			if (sprite->y < y0)
+				y0 = sprite->y;
+			if (sprite->x + sprite->width - 1 > x1)
+				x1 = sprite->x + sprite->width - 1;
+			if (sprite->y + sprite->height - 1 > y1)
+				y1 = sprite->y + sprite->height - 1;
+		}
+
+		sprite->drawn = sprite->visible;
+		sprite->drawn_x = sprite->x;
+		sprite->drawn_y = sprite->y;
+
+		GFXrect rect;
+		if (!clip_area(layer->canvas, x0, y0, x1, y1, &rect))
+			continue;
+
+		compose_area(layer, &rect);
+		send_rect_to_OLED(layer->canvas, rect.x0, rect.y0, rect.x1, rect.y1);
+	}
+}
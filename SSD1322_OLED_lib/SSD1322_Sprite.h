@@ -0,0 +1,75 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Sprite.h
+ *
+ * \brief Sprite layer composed over background picture line by line.
+ *
+ * Sprites are 4 bits per pixel bitmaps with one brightness value treated as transparent.
+ * When sprite is moved, only area covered by its old and new position is composed
+ * again and sent to OLED.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_SPRITE_H
+#define SSD1322_SPRITE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+
+/*============ defines ============*/
+
+// Size of work array needed by sprite_load() for precomputed pixels and masks
+#define SPRITE_WORK_SIZE(width, height)  (4 * ((width) / 2 + 1) * (height))
+
+/*============ sprite structures ============*/
+
+// Single sprite
+typedef struct {
+  uint16_t width;        ///< Width in pixels
+  uint16_t height;       ///< Height in pixels
+  uint16_t row_bytes;    ///< Length of one row of precomputed data and mask
+  uint8_t *data[2];      ///< Pixels for even and odd x position, transparent nibbles cleared
+  uint8_t *mask[2];      ///< Background nibbles to keep for even and odd x position
+  int16_t x;             ///< x position of top left corner, may be outside frame buffer
+  int16_t y;             ///< y position of top left corner, may be outside frame buffer
+  uint8_t z;             ///< Sprites with higher z are drawn on top
+  uint8_t visible;       ///< 1 if sprite should be drawn
+  int16_t drawn_x;       ///< x position at last update
+  int16_t drawn_y;       ///< y position at last update
+  uint8_t drawn;         ///< 1 if sprite was drawn at last update
+} GFXsprite;
+
+// Sprites drawn over common background
+typedef struct {
+  GFXsprite **sprites;         ///< Sprites sorted by z
+  uint8_t count;               ///< Amount of sprites
+  GFXcanvas *canvas;           ///< Canvas that layer is composed into
+  const uint8_t *background;   ///< Background in frame buffer format or NULL for black background
+} GFXsprite_layer;
+
+/*============ functions ============*/
+
+void sprite_load(GFXsprite *sprite, const uint8_t *bitmap, uint16_t width, uint16_t height, uint8_t transparent, uint8_t *work);
+void sprite_move(GFXsprite *sprite, int16_t x, int16_t y);
+void sprite_show(GFXsprite *sprite, uint8_t visible);
+
+void sprite_layer_init(GFXsprite_layer *layer, GFXcanvas *canvas, const uint8_t *background, GFXsprite **sprites, uint8_t count);
+void sprite_layer_redraw(GFXsprite_layer *layer);
+void sprite_layer_update(GFXsprite_layer *layer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_SPRITE_H */
@@ -0,0 +1,611 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Stroke.c
+ *
+ * \brief Lines and polylines wider than one pixel.
+ *
+ * Geometry is computed in 1/16 pixel units with pixel centers at (16 * x + 8, 16 * y + 8).
+ * Every segment is a quad, every corner is a miter quad, bevel triangle or circle
+ * and round ends are circles. For each row, spans where pieces cross the row center are
+ * merged and drawn with draw_hline(). Pixel is drawn if its center lies inside the stroke.
+ * Centers are sampled 1/16 pixel right and below, so polyline points (where pieces meet)
+ * never lie exactly on a sampled position. Antialiased version samples four lines per row, sums exact
+ * horizontal coverage of every pixel and keeps the brighter value on partly covered pixels.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Curves.h"
+#include "../SSD1322_OLED_lib/SSD1322_Stroke.h"
+
+#include <stdlib.h>
+
+// Polyline being stroked
+typedef struct {
+	const GFXpoint *points;
+	uint16_t count;
+	int32_t half;       ///< Half of line width in 1/16 pixel
+	uint8_t join;
+} stroke_path;
+
+// Convex part of stroke, in 1/16 pixel
+typedef struct {
+	int32_t x[4];
+	int32_t y[4];
+	uint8_t count;      ///< Amount of polygon corners, 0 for circle
+	int32_t radius;     ///< Circle radius, circle center is x[0], y[0]
+} stroke_piece;
+
+//====================== rounded division ========================//
+static int32_t div_round(int64_t a, int64_t b)
+{
+	if (b < 0)
+	{
+		a = -a;
+		b = -b;
+	}
+	return a >= 0 ? (a + b / 2) / b : -((-a + b / 2) / b);
+}
+
+//====================== divide by 16 rounding up ========================//
+static int32_t ceil_div16(int32_t value)
+{
+	return (value + 15 + 1024) / 16 - 64;    //valid for values down to -1024
+}
+
+//====================== compare points ========================//
+static uint8_t same_point(const GFXpoint *a, const GFXpoint *b)
+{
+	return a->x == b->x && a->y == b->y;
+}
+
+//====================== previous different point ========================//
+static int32_t prev_distinct(const stroke_path *path, uint16_t index)
+{
+	for (int32_t i = index - 1; i >= 0; i--)
+	{
+		if (!same_point(&path->points[i], &path->points[index]))
+			return i;
+	}
+	return -1;
+}
+
+//====================== next different point ========================//
+static int32_t next_distinct(const stroke_path *path, uint16_t index)
+{
+	for (int32_t i = index + 1; i < path->count; i++)
+	{
+		if (!same_point(&path->points[i], &path->points[index]))
+			return i;
+	}
+	return -1;
+}
+
+//====================== scale direction ========================//
+/**
+ *  @brief Gives vector of given length pointing along (dx, dy).
+ */
+static void scaled_direction(int32_t dx, int32_t dy, int32_t length, int32_t *ux, int32_t *uy)
+{
+	//only direction matters, so big vectors are shortened to keep squares in 32 bits
+	while (dx > 32767 || dx < -32767 || dy > 32767 || dy < -32767)
+	{
+		dx /= 2;
+		dy /= 2;
+	}
+	int32_t norm = curves_isqrt((uint32_t)(dx * dx) + (uint32_t)(dy * dy));
+
+	*ux = div_round((int64_t)dx * length, norm);
+	*uy = div_round((int64_t)dy * length, norm);
+}
+
+//====================== set polygon corner ========================//
+static void set_corner(stroke_piece *piece, uint8_t index, int32_t x, int32_t y)
+{
+	piece->x[index] = x;
+	piece->y[index] = y;
+}
+
+//====================== build stroke piece ========================//
+/**
+ *  @brief Computes piece of stroke if it can reach rows between top and bottom.
+ *
+ *  Pieces are numbered: segments first, then corners, then two ends.
+ *
+ *  @return 1 if piece was built, 0 if it is empty or out of rows
+ */
+static uint8_t build_piece(const stroke_path *path, uint16_t index, int32_t top, int32_t bottom, stroke_piece *piece)
+{
+	const GFXpoint *points = path->points;
+	uint16_t segments = path->count - 1;
+	uint16_t joins = path->count > 2 ? path->count - 2 : 0;
+	int32_t half = path->half;
+
+	//set for polygons too, so the whole piece is always defined
+	piece->radius = 0;
+
+	if (index < segments)
+	{
+		const GFXpoint *a = &points[index];
+		const GFXpoint *b = &points[index + 1];
+		int32_t ax = a->x * 16 + 8, ay = a->y * 16 + 8;
+		int32_t bx = b->x * 16 + 8, by = b->y * 16 + 8;
+		int32_t nx, ny, ex, ey;
+
+		if (same_point(a, b))
+			return 0;
+		if ((ay < by ? ay : by) - half - 8 >= bottom || (ay > by ? ay : by) + half + 8 < top)
+			return 0;
+
+		scaled_direction(bx - ax, by - ay, half, &ny, &nx);
+		nx = -nx;
+
+		//butt ends are moved out by half a pixel, so end pixels are drawn like in draw_line()
+		if (path->join != STROKE_JOIN_ROUND)
+		{
+			scaled_direction(bx - ax, by - ay, 8, &ex, &ey);
+			if (prev_distinct(path, index) < 0)
+			{
+				ax -= ex;
+				ay -= ey;
+			}
+			if (next_distinct(path, index + 1) < 0)
+			{
+				bx += ex;
+				by += ey;
+			}
+		}
+
+		piece->count = 4;
+		set_corner(piece, 0, ax + nx, ay + ny);
+		set_corner(piece, 1, bx + nx, by + ny);
+		set_corner(piece, 2, bx - nx, by - ny);
+		set_corner(piece, 3, ax - nx, ay - ny);
+		return 1;
+	}
+	index -= segments;
+
+	if (index < joins)
+	{
+		uint16_t j = index + 1;
+		int32_t a = prev_distinct(path, j);
+		int32_t c = next_distinct(path, j);
+		int32_t bx = points[j].x * 16 + 8, by = points[j].y * 16 + 8;
+
+		//repeated point has its corner drawn only once
+		if (a < 0 || c < 0 || same_point(&points[j], &points[j - 1]))
+			return 0;
+		if (by - STROKE_MITER_LIMIT * half >= bottom || by + STROKE_MITER_LIMIT * half < top)
+			return 0;
+
+		if (path->join == STROKE_JOIN_ROUND)
+		{
+			piece->count = 0;
+			piece->radius = half;
+			set_corner(piece, 0, bx, by);
+			return 1;
+		}
+
+		int32_t d1x = points[j].x - points[a].x, d1y = points[j].y - points[a].y;
+		int32_t d2x = points[c].x - points[j].x, d2y = points[c].y - points[j].y;
+		int32_t n1x, n1y, n2x, n2y;
+
+		//straight continuation needs no corner
+		if ((int64_t)d1x * d2y == (int64_t)d1y * d2x && (int64_t)d1x * d2x + (int64_t)d1y * d2y > 0)
+			return 0;
+
+		scaled_direction(d1x, d1y, half, &n1y, &n1x);
+		scaled_direction(d2x, d2y, half, &n2y, &n2x);
+		n1x = -n1x;
+		n2x = -n2x;
+
+		//corner is on the outer side of the turn
+		if ((int64_t)n1x * d2x + (int64_t)n1y * d2y > 0)
+		{
+			n1x = -n1x;
+			n1y = -n1y;
+			n2x = -n2x;
+			n2y = -n2y;
+		}
+
+		if (path->join == STROKE_JOIN_MITER)
+		{
+			//miter tip lies on bisector, half / cos(angle / 2) away from the corner
+			int64_t denominator = (int64_t)half * half + (int64_t)n1x * n2x + (int64_t)n1y * n2y;
+			if (denominator > 0)
+			{
+				int32_t mx = div_round((int64_t)(n1x + n2x) * half * half, denominator);
+				int32_t my = div_round((int64_t)(n1y + n2y) * half * half, denominator);
+				int64_t limit = (int64_t)STROKE_MITER_LIMIT * half;
+				if ((int64_t)mx * mx + (int64_t)my * my <= limit * limit)
+				{
+					piece->count = 4;
+					set_corner(piece, 0, bx, by);
+					set_corner(piece, 1, bx + n1x, by + n1y);
+					set_corner(piece, 2, bx + mx, by + my);
+					set_corner(piece, 3, bx + n2x, by + n2y);
+					return 1;
+				}
+			}
+		}
+
+		piece->count = 3;
+		set_corner(piece, 0, bx, by);
+		set_corner(piece, 1, bx + n1x, by + n1y);
+		set_corner(piece, 2, bx + n2x, by + n2y);
+		return 1;
+	}
+	index -= joins;
+
+	//ends
+	const GFXpoint *end = index == 0 ? &points[0] : &points[path->count - 1];
+	int32_t bx = end->x * 16 + 8, by = end->y * 16 + 8;
+	uint8_t single = next_distinct(path, 0) < 0;
+
+	if (by - half >= bottom || by + half < top)
+		return 0;
+
+	if (path->join == STROKE_JOIN_ROUND && !(single && index == 1))
+	{
+		piece->count = 0;
+		piece->radius = half;
+		set_corner(piece, 0, bx, by);
+		return 1;
+	}
+	if (single && index == 0)
+	{
+		//polyline without length is a square dot
+		piece->count = 4;
+		set_corner(piece, 0, bx - half, by - half);
+		set_corner(piece, 1, bx + half, by - half);
+		set_corner(piece, 2, bx + half, by + half);
+		set_corner(piece, 3, bx - half, by + half);
+		return 1;
+	}
+	return 0;
+}
+
+//====================== piece span ========================//
+/**
+ *  @brief Finds where line y crosses the piece.
+ *
+ *  @return 1 if line crosses the piece, 0 if not
+ */
+static uint8_t piece_span(const stroke_piece *piece, int32_t y, int32_t *x0, int32_t *x1)
+{
+	if (piece->count == 0)
+	{
+		int32_t dy = y - piece->y[0];
+		int32_t r = piece->radius;
+		if (dy * dy >= r * r)
+			return 0;
+		int32_t half = curves_isqrt(r * r - dy * dy);
+		*x0 = piece->x[0] - half;
+		*x1 = piece->x[0] + half;
+		return half > 0;
+	}
+
+	uint8_t found = 0;
+	for (uint8_t i = 0; i < piece->count; i++)
+	{
+		uint8_t j = (i + 1) % piece->count;
+		int32_t ax = piece->x[i], ay = piece->y[i];
+		int32_t bx = piece->x[j], by = piece->y[j];
+		if (ay > by)
+		{
+			int32_t tmp;
+			tmp = ax; ax = bx; bx = tmp;
+			tmp = ay; ay = by; by = tmp;
+		}
+		if (y < ay || y >= by)
+			continue;
+
+		int32_t x = ax + div_round((int64_t)(y - ay) * (bx - ax), by - ay);
+		if (!found || x < *x0)
+			*x0 = x;
+		if (!found || x > *x1)
+			*x1 = x;
+		found = 1;
+	}
+	return found && *x0 < *x1;
+}
+
+//====================== sort spans ========================//
+static void sort_spans(GFXspan *spans, uint16_t count)
+{
+	for (uint16_t i = 1; i < count; i++)
+	{
+		GFXspan span = spans[i];
+		uint16_t j = i;
+		while (j > 0 && spans[j - 1].x0 > span.x0)
+		{
+			spans[j] = spans[j - 1];
+			j--;
+		}
+		spans[j] = span;
+	}
+}
+
+//====================== merge spans ========================//
+/**
+ *  @brief Sorts spans and joins the ones that overlap.
+ *
+ *  @param[in] gap
+ *             spans separated by up to gap are joined too
+ *
+ *  @return amount of spans left
+ */
+static uint16_t merge_spans(GFXspan *spans, uint16_t count, int32_t gap)
+{
+	uint16_t merged = 0;
+
+	sort_spans(spans, count);
+	for (uint16_t i = 0; i < count; i++)
+	{
+		if (merged > 0 && spans[i].x0 <= spans[merged - 1].x1 + gap)
+		{
+			if (spans[i].x1 > spans[merged - 1].x1)
+				spans[merged - 1].x1 = spans[i].x1;
+		}
+		else
+		{
+			spans[merged++] = spans[i];
+		}
+	}
+	return merged;
+}
+
+//====================== draw row ========================//
+static void draw_row(GFXcanvas *canvas, uint16_t y, GFXspan *spans, uint16_t count, uint16_t width, uint8_t brightness)
+{
+	//pieces sharing an edge may be rounded 1/16 pixel apart
+	count = merge_spans(spans, count, 1);
+
+	for (uint16_t i = 0; i < count; i++)
+	{
+		//pixels whose sampled centers lie inside the span
+		int32_t x0 = ceil_div16(spans[i].x0 - 9);
+		int32_t x1 = ceil_div16(spans[i].x1 - 9) - 1;
+		if (x0 < 0)
+			x0 = 0;
+		if (x1 > width - 1)
+			x1 = width - 1;
+		if (x0 <= x1)
+			draw_hline(canvas, y, x0, x1, brightness);
+	}
+}
+
+//====================== blend antialiased pixel ========================//
+/**
+ *  @brief Draws pixel with part of brightness, only if it is brighter than existing one.
+ *
+ *  @param[in] coverage
+ *             part of pixel covered by stroke, 0-64
+ */
+static void plot_AA(GFXcanvas *canvas, uint16_t x, uint16_t y, uint8_t coverage, uint8_t brightness)
+{
+	uint8_t value = (brightness * coverage + 32) >> 6;
+	if (value > get_pixel(canvas, x, y))
+		draw_pixel(canvas, x, y, value);
+}
+
+//====================== draw antialiased row ========================//
+/**
+ *  @brief Draws row from four lists of spans, one for each sampled line.
+ */
+static void draw_AA_row(GFXcanvas *canvas, uint16_t y, GFXspan *spans, uint16_t stride, uint16_t count[4], uint16_t width,
+		uint8_t brightness)
+{
+	int32_t left = 0x7FFFFFFF, right = -0x7FFFFFFF;
+	uint16_t index[4] = { 0, 0, 0, 0 };
+
+	for (uint8_t line = 0; line < 4; line++)
+	{
+		GFXspan *list = spans + line * stride;
+		count[line] = merge_spans(list, count[line], 1);
+		if (count[line] == 0)
+			continue;
+		if (list[0].x0 < left)
+			left = list[0].x0;
+		if (list[count[line] - 1].x1 > right)
+			right = list[count[line] - 1].x1;
+	}
+	if (left >= right)
+		return;
+
+	int32_t first = (left + 1024) / 16 - 64;
+	int32_t last = (right - 1 + 1024) / 16 - 64;
+	int32_t run = -1;
+	if (first < 0)
+		first = 0;
+	if (last > width - 1)
+		last = width - 1;
+
+	for (int32_t x = first; x <= last; x++)
+	{
+		int32_t cell0 = x * 16, cell1 = cell0 + 16;
+		uint8_t coverage = 0;
+
+		for (uint8_t line = 0; line < 4; line++)
+		{
+			GFXspan *list = spans + line * stride;
+			while (index[line] < count[line] && list[index[line]].x1 <= cell0)
+				index[line]++;
+			for (uint16_t i = index[line]; i < count[line] && list[i].x0 < cell1; i++)
+			{
+				coverage += (list[i].x1 < cell1 ? list[i].x1 : cell1) - (list[i].x0 > cell0 ? list[i].x0 : cell0);
+			}
+		}
+
+		//fully covered pixels are collected into runs
+		if (coverage == 64)
+		{
+			if (run < 0)
+				run = x;
+			continue;
+		}
+		if (run >= 0)
+		{
+			draw_hline(canvas, y, run, x - 1, brightness);
+			run = -1;
+		}
+		if (coverage > 0)
+			plot_AA(canvas, x, y, coverage, brightness);
+	}
+	if (run >= 0)
+		draw_hline(canvas, y, run, last, brightness);
+}
+
+//====================== stroke polyline ========================//
+static void stroke(GFXcanvas *canvas, const GFXpoint *points, uint16_t count, uint8_t width, uint8_t join, uint8_t brightness,
+		GFXspan *work, uint8_t antialiased)
+{
+	stroke_path path = { points, count, width * 8, join };
+	uint16_t draw_width = (canvas->rotation & 1) ? canvas->height : canvas->width;
+	uint16_t draw_height = (canvas->rotation & 1) ? canvas->width : canvas->height;
+	uint8_t lines = antialiased ? 4 : 1;
+
+	if (count == 0 || width == 0)
+		return;
+
+	//segments, corners and two ends
+	uint16_t pieces = (count - 1) + (count > 2 ? count - 2 : 0) + 2;
+
+	//rows that any piece can reach
+	int32_t top = points[0].y, bottom = points[0].y;
+	for (uint16_t i = 1; i < count; i++)
+	{
+		if (points[i].y < top)
+			top = points[i].y;
+		if (points[i].y > bottom)
+			bottom = points[i].y;
+	}
+	int32_t reach = (STROKE_MITER_LIMIT * path.half + 8 + 15) / 16;
+	top = top - reach < 0 ? 0 : top - reach;
+	bottom = bottom + reach > draw_height - 1 ? draw_height - 1 : bottom + reach;
+
+	for (int32_t y = top; y <= bottom; y++)
+	{
+		uint16_t amount[4] = { 0, 0, 0, 0 };
+		stroke_piece piece;
+
+		for (uint16_t k = 0; k < pieces; k++)
+		{
+			if (!build_piece(&path, k, y * 16, y * 16 + 16, &piece))
+				continue;
+
+			for (uint8_t line = 0; line < lines; line++)
+			{
+				int32_t x0 = 0, x1 = 0;
+				int32_t center = antialiased ? y * 16 + 2 + 4 * line : y * 16 + 9;
+				if (!piece_span(&piece, center, &x0, &x1))
+					continue;
+				if (x0 < -16)
+					x0 = -16;
+				if (x1 > draw_width * 16 + 16)
+					x1 = draw_width * 16 + 16;
+				if (x0 >= x1)
+					continue;
+
+				GFXspan *span = &work[line * pieces + amount[line]++];
+				span->x0 = x0;
+				span->x1 = x1;
+			}
+		}
+
+		if (antialiased)
+			draw_AA_row(canvas, y, work, pieces, amount, draw_width, brightness);
+		else
+			draw_row(canvas, y, work, amount[0], draw_width, brightness);
+	}
+}
+
+//====================== draw thick line ========================//
+/**
+ *  @brief Draws line of any width
+ *
+ *  Ends are square and include end pixels, so line of width 1 matches draw_line().
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] x0
+ *             x position of line beginning
+ *  @param[in] y0
+ *             y position of line beginning
+ *  @param[in] x1
+ *             x position of line ending
+ *  @param[in] y1
+ *             y position of line ending
+ *  @param[in] width
+ *             width of line in pixels
+ * 	@param[in] brightness
+ *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
+ */
+void draw_thick_line(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t width, uint8_t brightness)
+{
+	GFXpoint points[2] = { { x0, y0 }, { x1, y1 } };
+	GFXspan work[STROKE_WORK_SPANS(2)];
+
+	stroke(canvas, points, 2, width, STROKE_JOIN_MITER, brightness, work, 0);
+}
+
+//====================== draw antialiased thick line ========================//
+/**
+ *  @brief Draws antialiased line of any width
+ *
+ *  Parameters are the same as in draw_thick_line().
+ */
+void draw_AA_thick_line(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t width, uint8_t brightness)
+{
+	GFXpoint points[2] = { { x0, y0 }, { x1, y1 } };
+	GFXspan work[STROKE_AA_WORK_SPANS(2)];
+
+	stroke(canvas, points, 2, width, STROKE_JOIN_MITER, brightness, work, 1);
+}
+
+//====================== draw polyline ========================//
+/**
+ *  @brief Draws connected line segments of any width
+ *
+ *  Every pixel is written once, also where segments and corners overlap.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in] points
+ *             corners of polyline
+ *  @param[in] count
+ *             amount of points
+ *  @param[in] width
+ *             width of line in pixels
+ *  @param[in] join
+ *             STROKE_JOIN_MITER, STROKE_JOIN_ROUND or STROKE_JOIN_BEVEL
+ * 	@param[in] brightness
+ *             brightness value of pixels (range 0-15 dec or 0x00-0x0F hex)
+ *  @param[in] work
+ *             array of STROKE_WORK_SPANS(count) spans
+ */
+void draw_polyline(GFXcanvas *canvas, const GFXpoint *points, uint16_t count, uint8_t width, uint8_t join, uint8_t brightness,
+		GFXspan *work)
+{
+	stroke(canvas, points, count, width, join, brightness, work, 0);
+}
+
+//====================== draw antialiased polyline ========================//
+/**
+ *  @brief Draws antialiased connected line segments of any width
+ *
+ *  Parameters are the same as in draw_polyline(), but work has to hold
+ *  STROKE_AA_WORK_SPANS(count) spans.
+ */
+void draw_AA_polyline(GFXcanvas *canvas, const GFXpoint *points, uint16_t count, uint8_t width, uint8_t join, uint8_t brightness,
+		GFXspan *work)
+{
+	stroke(canvas, points, count, width, join, brightness, work, 1);
+}
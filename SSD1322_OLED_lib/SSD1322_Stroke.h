@@ -0,0 +1,69 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Stroke.h
+ *
+ * \brief Lines and polylines wider than one pixel.
+ *
+ * Stroke is split into convex pieces (segments, joins and caps) and drawn row by row.
+ * Spans of all pieces in a row are merged before drawing, so every pixel is written once
+ * even where pieces overlap.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_STROKE_H
+#define SSD1322_STROKE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+
+/*============ defines ============*/
+
+#define STROKE_JOIN_MITER 0    ///< Sharp corners, butt ends
+#define STROKE_JOIN_ROUND 1    ///< Round corners, round ends
+#define STROKE_JOIN_BEVEL 2    ///< Cut corners, butt ends
+
+#define STROKE_MITER_LIMIT 4   ///< Miter longer than this many half widths is drawn as bevel
+
+// Amount of GFXspan elements of work array needed for polyline of given amount of points
+#define STROKE_WORK_SPANS(points)    (2 * (points))
+#define STROKE_AA_WORK_SPANS(points) (8 * (points))
+
+/*============ stroke structures ============*/
+
+// Point of a polyline
+typedef struct {
+  uint16_t x;  ///< x position
+  uint16_t y;  ///< y position
+} GFXpoint;
+
+// Horizontal span of one stroke piece in 1/16 pixel, used as work memory
+typedef struct {
+  int32_t x0;  ///< Beginning of span
+  int32_t x1;  ///< End of span
+} GFXspan;
+
+/*============ functions ============*/
+
+void draw_thick_line(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t width, uint8_t brightness);
+void draw_AA_thick_line(GFXcanvas *canvas, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t width, uint8_t brightness);
+void draw_polyline(GFXcanvas *canvas, const GFXpoint *points, uint16_t count, uint8_t width, uint8_t join, uint8_t brightness,
+		GFXspan *work);
+void draw_AA_polyline(GFXcanvas *canvas, const GFXpoint *points, uint16_t count, uint8_t width, uint8_t join, uint8_t brightness,
+		GFXspan *work);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_STROKE_H */
@@ -0,0 +1,172 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Ticker.c
+ *
+ * \brief Scrolling text (marquee) rendered once into an off-screen strip.
+ *
+ * Visible area shows strip pixels from (position - width) to (position - 1), pixels outside
+ * of the strip are background. Slice is copied with copy_rect(), so slice starting at odd
+ * strip pixel costs the same as an even one.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Ticker.h"
+
+#include <string.h>
+
+//====================== measure strip ========================//
+/**
+ *  @brief Computes size of strip needed for text.
+ *
+ *  @param[in] font
+ *             font of text
+ *  @param[in] text
+ *             UTF-8 encoded string
+ *  @param[out] strip_width
+ *             width of text in pixels, rounded up to even number
+ *  @param[out] strip_height
+ *             height of font from font_extent()
+ */
+void ticker_measure(const GFXfont *font, const char *text, uint16_t *strip_width, uint16_t *strip_height)
+{
+	GFXcanvas measure;
+	GFXtext_metrics metrics;
+	uint8_t ascent, descent;
+	int32_t width;
+
+	canvas_init(&measure, NULL, 0, 0);
+	select_font(&measure, font);
+	measure_text(&measure, text, &metrics);
+	font_extent(font, &ascent, &descent);
+
+	width = metrics.advance;
+	if (metrics.x + metrics.width > width)
+		width = metrics.x + metrics.width;
+
+	*strip_width = (width + 1) & ~1;
+	*strip_height = ascent + descent;
+}
+
+//====================== init ticker ========================//
+/**
+ *  @brief Renders text into strip and prepares ticker. Area is drawn on first ticker_step().
+ *
+ *  Ticker works in frame buffer coordinates, rotation and clipping of canvas are not used.
+ *  Visible area is cut to canvas.
+ *
+ *  @param[in] ticker
+ *             ticker to prepare
+ *  @param[in] canvas
+ *             canvas that ticker is drawn on
+ *  @param[in] font
+ *             font of text
+ *  @param[in] text
+ *             UTF-8 encoded string
+ *  @param[in] x
+ *             x position of top left corner of visible area
+ *  @param[in] y
+ *             y position of top left corner of visible area
+ *  @param[in] width
+ *             width of visible area in pixels, height is height of font
+ *  @param[in] brightness
+ *             brightness of text
+ *  @param[in] background
+ *             brightness of background
+ *  @param[in] work
+ *             array of TICKER_WORK_SIZE(strip_width, strip_height) bytes that has to stay valid
+ *             as long as ticker is used, strip size is given by ticker_measure()
+ */
+void ticker_init(GFXticker *ticker, GFXcanvas *canvas, const GFXfont *font, const char *text, uint16_t x, uint16_t y,
+		uint16_t width, uint8_t brightness, uint8_t background, uint8_t *work)
+{
+	uint16_t strip_width, strip_height;
+	uint8_t ascent, descent;
+
+	ticker_measure(font, text, &strip_width, &strip_height);
+	font_extent(font, &ascent, &descent);
+
+	if (x >= canvas->width || y >= canvas->height)
+		x = y = width = 0;
+	if (x + width > canvas->width)
+		width = canvas->width - x;
+
+	ticker->canvas = canvas;
+	ticker->x = x;
+	ticker->y = y;
+	ticker->width = width;
+	ticker->height = y + strip_height > canvas->height ? canvas->height - y : strip_height;
+	ticker->position = 0;
+	ticker->period = strip_width + width;
+	ticker->background = background;
+
+	canvas_init(&ticker->strip, work, strip_width, strip_height);
+	select_font(&ticker->strip, font);
+	fill_buffer(&ticker->strip, background);
+	draw_text(&ticker->strip, text, 0, ascent, brightness);
+}
+
+//====================== scroll ticker ========================//
+/**
+ *  @brief Scrolls text to the left, copies visible slice and sends it (or adds it to damage list).
+ *
+ *  Text enters from the right edge, leaves at the left one and enters again.
+ *
+ *  @param[in] ticker
+ *             ticker to update
+ *  @param[in,out] damage
+ *             list that visible area is added to, NULL to send it to OLED right away
+ *  @param[in] pixels
+ *             scroll distance in pixels, 0 only redraws current position
+ */
+void ticker_step(GFXticker *ticker, GFXdamage *damage, uint16_t pixels)
+{
+	GFXcanvas *canvas = ticker->canvas;
+	GFXrect rect = { ticker->x, ticker->y, ticker->x + ticker->width - 1, ticker->y + ticker->height - 1 };
+
+	if (ticker->width == 0 || ticker->height == 0)
+		return;
+
+	ticker->position = (ticker->position + pixels) % ticker->period;
+
+	//visible pixel i shows strip pixel (position - width + i)
+	int32_t first = (int32_t)ticker->position - ticker->width;
+	int32_t lead = first < 0 ? -first : 0;
+	int32_t start = first < 0 ? 0 : first;
+	int32_t count = ticker->strip.width - start;
+	if (count > ticker->width - lead)
+		count = ticker->width - lead;
+	if (count < 0)
+		count = 0;
+
+	//ticker is placed in frame buffer coordinates
+	GFXrect clip = canvas->clip;
+	uint8_t rotation = canvas->rotation;
+	canvas->rotation = GFX_ROTATION_0;
+	canvas_reset_clip(canvas);
+
+	if (lead > 0)
+		draw_rect_filled(canvas, rect.x0, rect.y0, rect.x0 + lead - 1, rect.y1, ticker->background);
+	if (count > 0)
+	{
+		GFXrect slice = { start, 0, start + count - 1, ticker->height - 1 };
+		copy_rect(canvas, rect.x0 + lead, rect.y0, &ticker->strip, &slice);
+	}
+	if (lead + count < ticker->width)
+		draw_rect_filled(canvas, rect.x0 + lead + count, rect.y0, rect.x1, rect.y1, ticker->background);
+
+	canvas->rotation = rotation;
+	canvas->clip = clip;
+
+	if (damage != NULL)
+		damage_add(damage, &rect);
+	else
+		send_rect_to_OLED(canvas, rect.x0, rect.y0, rect.x1, rect.y1);
+}
@@ -0,0 +1,59 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Ticker.h
+ *
+ * \brief Scrolling text (marquee) rendered once into an off-screen strip.
+ *
+ * Text is drawn only when ticker is prepared. Each step copies visible slice of the strip
+ * into ticker area of frame buffer and sends only this area to OLED.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_TICKER_H
+#define SSD1322_TICKER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+
+/*============ defines ============*/
+
+// Size of work array for rendered text, strip size is given by ticker_measure()
+#define TICKER_WORK_SIZE(strip_width, strip_height)  ((((strip_width) + 1) / 2) * (strip_height))
+
+/*============ ticker structure ============*/
+
+typedef struct {
+  GFXcanvas *canvas;        ///< Canvas that ticker is drawn on
+  uint16_t x;               ///< x position of top left corner in frame buffer coordinates
+  uint16_t y;               ///< y position of top left corner in frame buffer coordinates
+  uint16_t width;           ///< Width of visible area in pixels
+  uint16_t height;          ///< Height of visible area and strip in pixels
+  GFXcanvas strip;          ///< Rendered text
+  uint16_t position;        ///< Scroll position, 0 when text starts to enter from the right
+  uint16_t period;          ///< Scroll positions before text enters again, strip width + visible width
+  uint8_t background;       ///< Brightness of area around text
+} GFXticker;
+
+/*============ functions ============*/
+
+void ticker_measure(const GFXfont *font, const char *text, uint16_t *strip_width, uint16_t *strip_height);
+void ticker_init(GFXticker *ticker, GFXcanvas *canvas, const GFXfont *font, const char *text, uint16_t x, uint16_t y,
+		uint16_t width, uint8_t brightness, uint8_t background, uint8_t *work);
+void ticker_step(GFXticker *ticker, GFXdamage *damage, uint16_t pixels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_TICKER_H */
@@ -0,0 +1,621 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Widgets.c
+ *
+ * \brief Dashboard widgets redrawn only when their value changes.
+ *
+ * Each redraw is done with canvas clipping set to the redrawn area, so drawing functions
+ * can not touch anything outside of it, and the same clipping rectangle (already in frame
+ * buffer coordinates) is added to damage list.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+//====================== Includes ====================//
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+#include "../SSD1322_OLED_lib/SSD1322_Widgets.h"
+#include "../SSD1322_OLED_lib/SSD1322_Curves.h"
+
+#include <string.h>
+
+//====================== begin redraw ========================//
+/**
+ *  @brief Limits drawing to area of widget (and to clipping set by user) and saves previous clipping.
+ */
+static void begin_area(GFXcanvas *canvas, const GFXrect *area, GFXrect *saved)
+{
+	*saved = canvas->clip;
+	canvas_set_clip(canvas, area);
+
+	if (canvas->clip.x0 < saved->x0)
+		canvas->clip.x0 = saved->x0;
+	if (canvas->clip.y0 < saved->y0)
+		canvas->clip.y0 = saved->y0;
+	if (canvas->clip.x1 > saved->x1)
+		canvas->clip.x1 = saved->x1;
+	if (canvas->clip.y1 > saved->y1)
+		canvas->clip.y1 = saved->y1;
+}
+
+//====================== end redraw ========================//
+/**
+ *  @brief Adds redrawn area to damage list (if given) and restores previous clipping.
+ */
+static void end_area(GFXcanvas *canvas, GFXdamage *damage, const GFXrect *saved)
+{
+	if (damage != NULL && canvas->clip.x0 <= canvas->clip.x1 && canvas->clip.y0 <= canvas->clip.y1)
+		damage_add(damage, &canvas->clip);
+	canvas->clip = *saved;
+}
+
+//====================== draw text in box ========================//
+/**
+ *  @brief Draws single line of text aligned horizontally and centered vertically in a box.
+ *
+ *  Baseline position depends only on font, so text does not jump when its characters change.
+ */
+static void draw_text_in(GFXcanvas *canvas, const GFXfont *font, const char *text, const GFXrect *box, uint8_t align, uint8_t brightness)
+{
+	const GFXfont *selected = canvas->font;
+	GFXtext_metrics metrics;
+	uint8_t ascent, descent;
+	int32_t width = box->x1 - box->x0 + 1;
+	int32_t height = box->y1 - box->y0 + 1;
+	int32_t x = box->x0;
+	int32_t y = box->y0;
+
+	canvas->font = font;
+	measure_text(canvas, text, &metrics);
+	font_extent(font, &ascent, &descent);
+
+	if (align == GFX_ALIGN_CENTER)
+		x += (width - metrics.advance) / 2;
+	else if (align == GFX_ALIGN_RIGHT)
+		x += width - metrics.advance;
+	if (x < box->x0)
+		x = box->x0;
+	if (height > ascent + descent)
+		y += (height - ascent - descent) / 2;
+
+	draw_text(canvas, text, x, y + ascent, brightness);
+	canvas->font = selected;
+}
+
+//====================== format fixed point number ========================//
+/**
+ *  @brief Converts integer to decimal string with decimal point, without printf.
+ *
+ *  Value 1234 with 2 decimals gives "12.34", value -5 with 2 decimals gives "-0.05".
+ *
+ *  @param[in] value
+ *             number to convert
+ *  @param[in] decimals
+ *             digits after decimal point, up to 10
+ *  @param[out] text
+ *             array of at least WIDGET_NUMBER_TEXT_SIZE characters
+ *
+ *  @return length of string
+ */
+uint8_t format_fixed(int32_t value, uint8_t decimals, char *text)
+{
+	char digits[WIDGET_NUMBER_TEXT_SIZE];
+	uint32_t v = value < 0 ? -(uint32_t)value : (uint32_t)value;
+	uint8_t n = 0, d = 0, length = 0;
+
+	if (decimals > 10)
+		decimals = 10;
+
+	//digits are collected from the least significant one
+	do
+	{
+		if (d == decimals && decimals)
+			digits[n++] = '.';
+		digits[n++] = '0' + v % 10;
+		v /= 10;
+		d++;
+	} while (v || d <= decimals);
+
+	if (value < 0)
+		text[length++] = '-';
+	while (n)
+		text[length++] = digits[--n];
+	text[length] = 0;
+	return length;
+}
+
+//====================== init label ========================//
+/**
+ *  @brief Prepares empty label. Text is drawn on first label_set().
+ *
+ *  @param[in] label
+ *             label to prepare
+ *  @param[in] bounds
+ *             area of label in drawing coordinates
+ *  @param[in] font
+ *             font of text
+ *  @param[in] align
+ *             GFX_ALIGN_LEFT, GFX_ALIGN_CENTER or GFX_ALIGN_RIGHT
+ */
+void label_init(GFXlabel *label, const GFXrect *bounds, const GFXfont *font, uint8_t align)
+{
+	label->bounds = *bounds;
+	label->font = font;
+	label->align = align;
+	label->brightness = 15;
+	label->background = 0;
+	label->drawn = 0;
+	label->text[0] = 0;
+}
+
+//====================== set label text ========================//
+/**
+ *  @brief Redraws label if its text has changed.
+ *
+ *  Text longer than WIDGET_LABEL_TEXT_SIZE - 1 bytes is cut at the last whole UTF-8 character.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in,out] damage
+ *             list that redrawn area is added to, may be NULL
+ *  @param[in] label
+ *             label to update
+ *  @param[in] text
+ *             new text
+ *
+ *  @return 1 if label was redrawn, 0 if text is the same
+ */
+uint8_t label_set(GFXcanvas *canvas, GFXdamage *damage, GFXlabel *label, const char *text)
+{
+	uint16_t length = strlen(text);
+	GFXrect saved;
+
+	if (length > WIDGET_LABEL_TEXT_SIZE - 1)
+	{
+		length = WIDGET_LABEL_TEXT_SIZE - 1;
+		while (length && ((uint8_t)text[length] & 0xC0) == 0x80)
+			length--;
+	}
+	if (label->drawn && strncmp(label->text, text, length) == 0 && label->text[length] == 0)
+		return 0;
+
+	memcpy(label->text, text, length);
+	label->text[length] = 0;
+
+	begin_area(canvas, &label->bounds, &saved);
+	draw_rect_filled(canvas, label->bounds.x0, label->bounds.y0, label->bounds.x1, label->bounds.y1, label->background);
+	draw_text_in(canvas, label->font, label->text, &label->bounds, label->align, label->brightness);
+	end_area(canvas, damage, &saved);
+
+	label->drawn = 1;
+	return 1;
+}
+
+//====================== init number ========================//
+/**
+ *  @brief Prepares number readout. Value is drawn on first number_set().
+ *
+ *  @param[in] number
+ *             readout to prepare
+ *  @param[in] bounds
+ *             area of readout in drawing coordinates
+ *  @param[in] font
+ *             font of digits
+ *  @param[in] align
+ *             GFX_ALIGN_LEFT, GFX_ALIGN_CENTER or GFX_ALIGN_RIGHT
+ *  @param[in] decimals
+ *             digits after decimal point
+ */
+void number_init(GFXnumber *number, const GFXrect *bounds, const GFXfont *font, uint8_t align, uint8_t decimals)
+{
+	number->bounds = *bounds;
+	number->font = font;
+	number->align = align;
+	number->brightness = 15;
+	number->background = 0;
+	number->decimals = decimals;
+	number->drawn = 0;
+	number->value = 0;
+}
+
+//====================== set number value ========================//
+/**
+ *  @brief Redraws readout if its value has changed.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in,out] damage
+ *             list that redrawn area is added to, may be NULL
+ *  @param[in] number
+ *             readout to update
+ *  @param[in] value
+ *             new value as integer, decimal point is placed according to number->decimals
+ *
+ *  @return 1 if readout was redrawn, 0 if value is the same
+ */
+uint8_t number_set(GFXcanvas *canvas, GFXdamage *damage, GFXnumber *number, int32_t value)
+{
+	char text[WIDGET_NUMBER_TEXT_SIZE];
+	GFXrect saved;
+
+	if (number->drawn && number->value == value)
+		return 0;
+
+	format_fixed(value, number->decimals, text);
+
+	begin_area(canvas, &number->bounds, &saved);
+	draw_rect_filled(canvas, number->bounds.x0, number->bounds.y0, number->bounds.x1, number->bounds.y1, number->background);
+	draw_text_in(canvas, number->font, text, &number->bounds, number->align, number->brightness);
+	end_area(canvas, damage, &saved);
+
+	number->value = value;
+	number->drawn = 1;
+	return 1;
+}
+
+//====================== init bar ========================//
+/**
+ *  @brief Prepares bar meter. Frame and bar are drawn on first bar_set().
+ *
+ *  Bar wider than high grows from left to right, otherwise from bottom to top.
+ *  It is drawn inside 1 pixel frame with 1 pixel gap, so bounds should be at least 5x5 pixels.
+ *
+ *  @param[in] bar
+ *             bar to prepare
+ *  @param[in] bounds
+ *             area of bar including frame, in drawing coordinates
+ *  @param[in] min
+ *             value shown as empty bar
+ *  @param[in] max
+ *             value shown as full bar, has to be different from min
+ */
+void bar_init(GFXbar *bar, const GFXrect *bounds, int32_t min, int32_t max)
+{
+	bar->bounds = *bounds;
+	bar->min = min;
+	bar->max = max;
+	bar->brightness = 15;
+	bar->background = 0;
+	bar->drawn = 0;
+	bar->fill = 0;
+}
+
+//====================== draw bar strip ========================//
+/**
+ *  @brief Draws part of bar between lengths from and to (excluding to).
+ */
+static void draw_bar_strip(GFXcanvas *canvas, GFXdamage *damage, const GFXbar *bar, uint16_t from, uint16_t to, uint8_t brightness)
+{
+	GFXrect strip = { bar->bounds.x0 + 2, bar->bounds.y0 + 2, bar->bounds.x1 - 2, bar->bounds.y1 - 2 };
+	GFXrect saved;
+
+	if (bar->bounds.x1 - bar->bounds.x0 > bar->bounds.y1 - bar->bounds.y0)
+	{
+		strip.x1 = strip.x0 + to - 1;
+		strip.x0 = strip.x0 + from;
+	}
+	else
+	{
+		strip.y0 = strip.y1 - to + 1;
+		strip.y1 = strip.y1 - from;
+	}
+
+	begin_area(canvas, &strip, &saved);
+	draw_rect_filled(canvas, strip.x0, strip.y0, strip.x1, strip.y1, brightness);
+	end_area(canvas, damage, &saved);
+}
+
+//====================== set bar value ========================//
+/**
+ *  @brief Updates bar meter. Only the part between old and new bar end is redrawn.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in,out] damage
+ *             list that redrawn area is added to, may be NULL
+ *  @param[in] bar
+ *             bar to update
+ *  @param[in] value
+ *             new value, clamped to min..max
+ *
+ *  @return 1 if bar was redrawn, 0 if its length is the same
+ */
+uint8_t bar_set(GFXcanvas *canvas, GFXdamage *damage, GFXbar *bar, int32_t value)
+{
+	int32_t width = bar->bounds.x1 - bar->bounds.x0 + 1;
+	int32_t height = bar->bounds.y1 - bar->bounds.y0 + 1;
+	int32_t length = (width > height ? width : height) - 4;
+	int32_t low = bar->min < bar->max ? bar->min : bar->max;
+	int32_t high = bar->min < bar->max ? bar->max : bar->min;
+	uint16_t fill;
+	GFXrect saved;
+
+	if (length < 0 || (width < 5 || height < 5))
+		length = 0;
+	if (value < low)
+		value = low;
+	if (value > high)
+		value = high;
+	fill = (int64_t)(value - bar->min) * length / (bar->max - bar->min);
+
+	if (!bar->drawn)
+	{
+		begin_area(canvas, &bar->bounds, &saved);
+		draw_rect_filled(canvas, bar->bounds.x0, bar->bounds.y0, bar->bounds.x1, bar->bounds.y1, bar->background);
+		draw_rect(canvas, bar->bounds.x0, bar->bounds.y0, bar->bounds.x1, bar->bounds.y1, bar->brightness);
+		if (fill)
+			draw_bar_strip(canvas, NULL, bar, 0, fill, bar->brightness);
+		end_area(canvas, damage, &saved);
+	}
+	else if (fill > bar->fill)
+	{
+		draw_bar_strip(canvas, damage, bar, bar->fill, fill, bar->brightness);
+	}
+	else if (fill < bar->fill)
+	{
+		draw_bar_strip(canvas, damage, bar, fill, bar->fill, bar->background);
+	}
+	else
+	{
+		return 0;
+	}
+
+	bar->fill = fill;
+	bar->drawn = 1;
+	return 1;
+}
+
+//====================== init gauge ========================//
+/**
+ *  @brief Prepares half circle gauge. Dial and needle are drawn on first gauge_set().
+ *
+ *  Dial center is in the middle of bottom edge of bounds and radius is the largest
+ *  that fits in bounds.
+ *
+ *  @param[in] gauge
+ *             gauge to prepare
+ *  @param[in] bounds
+ *             area of gauge in drawing coordinates
+ *  @param[in] min
+ *             value shown at the left end of dial
+ *  @param[in] max
+ *             value shown at the right end of dial, has to be different from min
+ */
+void gauge_init(GFXgauge *gauge, const GFXrect *bounds, int32_t min, int32_t max)
+{
+	gauge->bounds = *bounds;
+	gauge->min = min;
+	gauge->max = max;
+	gauge->brightness = 15;
+	gauge->background = 0;
+	gauge->drawn = 0;
+	gauge->needle_x = 0;
+	gauge->needle_y = 0;
+}
+
+//====================== gauge radius ========================//
+static uint16_t gauge_radius(const GFXgauge *gauge)
+{
+	uint16_t half_width = (gauge->bounds.x1 - gauge->bounds.x0) / 2;
+	uint16_t height = gauge->bounds.y1 - gauge->bounds.y0;
+	return half_width < height ? half_width : height;
+}
+
+//====================== scale by sine ========================//
+/**
+ *  @brief Multiplies distance by sine or cosine scaled by 16384, rounded half away from zero.
+ */
+static int16_t scale_by_sine(int32_t distance, int16_t sine)
+{
+	int32_t product = distance * sine;
+	return product >= 0 ? (product + 8192) / 16384 : -((8192 - product) / 16384);
+}
+
+//====================== point on dial ========================//
+/**
+ *  @brief Computes point at given distance from dial center, angle 180 degrees at the left end, 0 at the right end.
+ */
+static void dial_point(const GFXgauge *gauge, int16_t angle, uint16_t distance, uint16_t *x, uint16_t *y)
+{
+	uint16_t cx = (gauge->bounds.x0 + gauge->bounds.x1) / 2;
+	uint16_t cy = gauge->bounds.y1;
+
+	*x = cx + scale_by_sine(distance, curves_cos_deg(angle));
+	*y = cy - scale_by_sine(distance, curves_sin_deg(angle));
+}
+
+//====================== draw gauge ========================//
+/**
+ *  @brief Draws whole gauge. Caller limits drawing to the area that has to be refreshed.
+ */
+static void draw_gauge(GFXcanvas *canvas, const GFXgauge *gauge, uint16_t needle_x, uint16_t needle_y)
+{
+	uint16_t r = gauge_radius(gauge);
+	uint16_t cx = (gauge->bounds.x0 + gauge->bounds.x1) / 2;
+	uint16_t cy = gauge->bounds.y1;
+	uint16_t x0, y0, x1, y1;
+
+	draw_rect_filled(canvas, gauge->bounds.x0, gauge->bounds.y0, gauge->bounds.x1, gauge->bounds.y1, gauge->background);
+	draw_circle(canvas, cx, cy, r, gauge->brightness);
+	for (uint8_t i = 0; i <= 4; i++)
+	{
+		dial_point(gauge, 180 - i * 45, r - r / 6, &x0, &y0);
+		dial_point(gauge, 180 - i * 45, r, &x1, &y1);
+		draw_line(canvas, x0, y0, x1, y1, gauge->brightness);
+	}
+	draw_line(canvas, cx, cy, needle_x, needle_y, gauge->brightness);
+	draw_rect_filled(canvas, cx - 1, cy - 2, cx + 1, cy, gauge->brightness);
+}
+
+//====================== set gauge value ========================//
+/**
+ *  @brief Moves gauge needle. Only bounding box of old and new needle is redrawn.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in,out] damage
+ *             list that redrawn area is added to, may be NULL
+ *  @param[in] gauge
+ *             gauge to update
+ *  @param[in] value
+ *             new value, clamped to min..max
+ *
+ *  @return 1 if gauge was redrawn, 0 if needle position is the same
+ */
+uint8_t gauge_set(GFXcanvas *canvas, GFXdamage *damage, GFXgauge *gauge, int32_t value)
+{
+	uint16_t r = gauge_radius(gauge);
+	uint16_t cx = (gauge->bounds.x0 + gauge->bounds.x1) / 2;
+	uint16_t cy = gauge->bounds.y1;
+	int64_t range = (int64_t)gauge->max - gauge->min;
+	int64_t position = (int64_t)value - gauge->min;
+	uint16_t needle_x, needle_y;
+	GFXrect area = gauge->bounds;
+	GFXrect saved;
+
+	if (position < 0 || range <= 0)
+		position = 0;
+	if (position > range)
+		position = range;
+	//needle moves in whole degrees, from 180 at min to 0 at max
+	int16_t angle = range > 0 ? 180 - (position * 180 + range / 2) / range : 180;
+	dial_point(gauge, angle, r - r / 4, &needle_x, &needle_y);
+
+	if (gauge->drawn)
+	{
+		if (needle_x == gauge->needle_x && needle_y == gauge->needle_y)
+			return 0;
+
+		//box around hub, old needle and new needle
+		area.x0 = cx - 1;
+		area.x1 = cx + 1;
+		area.y0 = cy - 2;
+		area.y1 = cy;
+		if (needle_x < area.x0 || gauge->needle_x < area.x0)
+			area.x0 = needle_x < gauge->needle_x ? needle_x : gauge->needle_x;
+		if (needle_x > area.x1 || gauge->needle_x > area.x1)
+			area.x1 = needle_x > gauge->needle_x ? needle_x : gauge->needle_x;
+		if (needle_y < area.y0 || gauge->needle_y < area.y0)
+			area.y0 = needle_y < gauge->needle_y ? needle_y : gauge->needle_y;
+	}
+
+	begin_area(canvas, &area, &saved);
+	draw_gauge(canvas, gauge, needle_x, needle_y);
+	end_area(canvas, damage, &saved);
+
+	gauge->needle_x = needle_x;
+	gauge->needle_y = needle_y;
+	gauge->drawn = 1;
+	return 1;
+}
+
+//====================== init list ========================//
+/**
+ *  @brief Prepares list with first item selected. Items are drawn on first list_select().
+ *
+ *  @param[in] list
+ *             list to prepare
+ *  @param[in] bounds
+ *             area of list in drawing coordinates
+ *  @param[in] font
+ *             font of items, height of a row is font yAdvance
+ *  @param[in] items
+ *             array of item texts that has to stay valid as long as list is used
+ *  @param[in] count
+ *             amount of items
+ */
+void list_init(GFXlist *list, const GFXrect *bounds, const GFXfont *font, const char *const *items, uint8_t count)
+{
+	list->bounds = *bounds;
+	list->font = font;
+	list->items = items;
+	list->count = count;
+	list->brightness = 15;
+	list->background = 0;
+	list->drawn = 0;
+	list->selected = 0;
+	list->top = 0;
+}
+
+//====================== draw list row ========================//
+/**
+ *  @brief Draws one visible item, selected item is drawn inverted.
+ */
+static void draw_row(GFXcanvas *canvas, GFXdamage *damage, const GFXlist *list, uint8_t index)
+{
+	GFXrect row = list->bounds;
+	GFXrect text_box;
+	GFXrect saved;
+	uint8_t selected = index == list->selected;
+
+	row.y0 = list->bounds.y0 + (index - list->top) * list->font->yAdvance;
+	row.y1 = row.y0 + list->font->yAdvance - 1;
+	text_box = row;
+	text_box.x0 += 2;
+
+	begin_area(canvas, &row, &saved);
+	draw_rect_filled(canvas, row.x0, row.y0, row.x1, row.y1, selected ? list->brightness : list->background);
+	draw_text_in(canvas, list->font, list->items[index], &text_box, GFX_ALIGN_LEFT, selected ? list->background : list->brightness);
+	end_area(canvas, damage, &saved);
+}
+
+//====================== select list item ========================//
+/**
+ *  @brief Selects item and scrolls list so that it is visible.
+ *
+ *  If list has not scrolled, only rows of previously and newly selected items are redrawn.
+ *
+ *  @param[in] canvas
+ *             canvas to draw on
+ *  @param[in,out] damage
+ *             list that redrawn area is added to, may be NULL
+ *  @param[in] list
+ *             list to update
+ *  @param[in] selected
+ *             index of item to select, clamped to the last item
+ *
+ *  @return 1 if list was redrawn, 0 if selection is the same
+ */
+uint8_t list_select(GFXcanvas *canvas, GFXdamage *damage, GFXlist *list, uint8_t selected)
+{
+	uint8_t rows = (list->bounds.y1 - list->bounds.y0 + 1) / list->font->yAdvance;
+	uint8_t previous = list->selected;
+	uint8_t previous_top = list->top;
+	GFXrect saved;
+
+	if (list->count == 0 || rows == 0)
+		return 0;
+	if (selected >= list->count)
+		selected = list->count - 1;
+	if (list->drawn && selected == previous)
+		return 0;
+
+	if (selected < list->top)
+		list->top = selected;
+	if (selected >= list->top + rows)
+		list->top = selected - rows + 1;
+	list->selected = selected;
+
+	if (!list->drawn || list->top != previous_top)
+	{
+		begin_area(canvas, &list->bounds, &saved);
+		draw_rect_filled(canvas, list->bounds.x0, list->bounds.y0, list->bounds.x1, list->bounds.y1, list->background);
+		for (uint8_t i = list->top; i < list->count && i < list->top + rows; i++)
+		{
+			draw_row(canvas, NULL, list, i);
+		}
+		end_area(canvas, damage, &saved);
+	}
+	else
+	{
+		draw_row(canvas, damage, list, previous);
+		draw_row(canvas, damage, list, selected);
+	}
+
+	list->drawn = 1;
+	return 1;
+}
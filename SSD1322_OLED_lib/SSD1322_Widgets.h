@@ -0,0 +1,119 @@
+/**
+ ****************************************************************************************
+ *
+ * \file SSD1322_Widgets.h
+ *
+ * \brief Dashboard widgets redrawn only when their value changes.
+ *
+ * Every widget remembers what it has drawn. Setting the same value again costs only
+ * a comparison, new value is drawn only inside widget bounds (or only inside the part
+ * that has changed) and the redrawn area is added to a damage list for partial upload.
+ *
+ * Copyright (C) 2020 Wojciech Klimek
+ * MIT license:
+ * https://github.com/wjklimek1/SSD1322_OLED_library
+ *
+ ****************************************************************************************
+ */
+
+#ifndef SSD1322_WIDGETS_H
+#define SSD1322_WIDGETS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "../SSD1322_OLED_lib/SSD1322_GFX.h"
+
+/*============ defines ============*/
+
+#define WIDGET_LABEL_TEXT_SIZE   32    //longest label text including terminating zero
+#define WIDGET_NUMBER_TEXT_SIZE  14    //longest formatted int32_t with sign, point and terminating zero
+
+/*============ widget structures ============*/
+
+// Text label
+typedef struct {
+  GFXrect bounds;          ///< Area of widget
+  const GFXfont *font;     ///< Font of text
+  uint8_t align;           ///< GFX_ALIGN_LEFT, GFX_ALIGN_CENTER or GFX_ALIGN_RIGHT
+  uint8_t brightness;      ///< Brightness of text
+  uint8_t background;      ///< Brightness of background
+  uint8_t drawn;           ///< 1 if text below is displayed, clear to force redraw
+  char text[WIDGET_LABEL_TEXT_SIZE];   ///< Displayed text
+} GFXlabel;
+
+// Fixed point number
+typedef struct {
+  GFXrect bounds;          ///< Area of widget
+  const GFXfont *font;     ///< Font of digits
+  uint8_t align;           ///< GFX_ALIGN_LEFT, GFX_ALIGN_CENTER or GFX_ALIGN_RIGHT
+  uint8_t brightness;      ///< Brightness of digits
+  uint8_t background;      ///< Brightness of background
+  uint8_t decimals;        ///< Digits after decimal point, value 1234 with 2 decimals is shown as 12.34
+  uint8_t drawn;           ///< 1 if value below is displayed, clear to force redraw
+  int32_t value;           ///< Displayed value
+} GFXnumber;
+
+// Bar meter, horizontal if wider than high, vertical otherwise
+typedef struct {
+  GFXrect bounds;          ///< Area of widget including frame
+  int32_t min;             ///< Value shown as empty bar
+  int32_t max;             ///< Value shown as full bar
+  uint8_t brightness;      ///< Brightness of frame and bar
+  uint8_t background;      ///< Brightness of empty part
+  uint8_t drawn;           ///< 1 if fill below is displayed, clear to force redraw
+  uint16_t fill;           ///< Displayed length of bar in pixels
+} GFXbar;
+
+// Half circle gauge with needle
+typedef struct {
+  GFXrect bounds;          ///< Area of widget, dial center is in the middle of bottom edge
+  int32_t min;             ///< Value shown at the left end of dial
+  int32_t max;             ///< Value shown at the right end of dial
+  uint8_t brightness;      ///< Brightness of dial and needle
+  uint8_t background;      ///< Brightness of background
+  uint8_t drawn;           ///< 1 if needle below is displayed, clear to force redraw
+  uint16_t needle_x;       ///< Displayed needle end
+  uint16_t needle_y;       ///< Displayed needle end
+} GFXgauge;
+
+// Scrolled list with one selected item
+typedef struct {
+  GFXrect bounds;          ///< Area of widget
+  const GFXfont *font;     ///< Font of items, row height is font yAdvance
+  const char *const *items; ///< Item texts
+  uint8_t count;           ///< Amount of items
+  uint8_t brightness;      ///< Brightness of text and selection bar
+  uint8_t background;      ///< Brightness of background
+  uint8_t drawn;           ///< 1 if items below are displayed, clear to force redraw
+  uint8_t selected;        ///< Displayed selected item
+  uint8_t top;             ///< Displayed first visible item
+} GFXlist;
+
+/*============ functions ============*/
+
+uint8_t format_fixed(int32_t value, uint8_t decimals, char *text);
+
+void label_init(GFXlabel *label, const GFXrect *bounds, const GFXfont *font, uint8_t align);
+uint8_t label_set(GFXcanvas *canvas, GFXdamage *damage, GFXlabel *label, const char *text);
+
+void number_init(GFXnumber *number, const GFXrect *bounds, const GFXfont *font, uint8_t align, uint8_t decimals);
+uint8_t number_set(GFXcanvas *canvas, GFXdamage *damage, GFXnumber *number, int32_t value);
+
+void bar_init(GFXbar *bar, const GFXrect *bounds, int32_t min, int32_t max);
+uint8_t bar_set(GFXcanvas *canvas, GFXdamage *damage, GFXbar *bar, int32_t value);
+
+void gauge_init(GFXgauge *gauge, const GFXrect *bounds, int32_t min, int32_t max);
+uint8_t gauge_set(GFXcanvas *canvas, GFXdamage *damage, GFXgauge *gauge, int32_t value);
+
+void list_init(GFXlist *list, const GFXrect *bounds, const GFXfont *font, const char *const *items, uint8_t count);
+uint8_t list_select(GFXcanvas *canvas, GFXdamage *damage, GFXlist *list, uint8_t selected);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSD1322_WIDGETS_H */